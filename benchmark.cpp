@@ -0,0 +1,341 @@
+// g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -o benchmark && ./benchmark [maxCount]
+
+#include "fastallocator.h"
+#include "unrolled_list.h"
+#include <list>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+std::atomic<size_t> allocationsCnt{0};
+
+void* operator new(size_t size)
+{
+    allocationsCnt.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    allocationsCnt.fetch_add(1, std::memory_order_relaxed);
+    size_t alignment = static_cast<size_t>(align);
+    if (void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    operator delete(ptr);
+}
+
+template<size_t size>
+struct Payload
+{
+    uint8_t bytes[size];
+
+    Payload(size_t value = 0)
+    {
+        std::memset(bytes, static_cast<int>(value), size);
+    }
+};
+
+size_t residentBytes()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    size_t pages = 0;
+    size_t resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+class Measurement
+{
+public:
+    Measurement(const char* container, size_t elementSz, size_t count);
+    void start();
+    void stop(size_t ops);
+    void report(const char* operation, size_t rssBytes = 0);
+
+private:
+    const char* container;
+    size_t elementSz;
+    size_t count;
+    std::chrono::steady_clock::time_point begin;
+    size_t beginAllocations = 0;
+    double elapsedNs = 0;
+    size_t allocations = 0;
+    size_t opsCnt = 0;
+};
+
+Measurement::Measurement(const char* container, size_t elementSz, size_t count) :
+        container(container),
+        elementSz(elementSz),
+        count(count) {}
+
+void Measurement::start()
+{
+    beginAllocations = allocationsCnt.load(std::memory_order_relaxed);
+    begin = std::chrono::steady_clock::now();
+}
+
+void Measurement::stop(size_t ops)
+{
+    auto end = std::chrono::steady_clock::now();
+    elapsedNs += std::chrono::duration<double, std::nano>(end - begin).count();
+    allocations += allocationsCnt.load(std::memory_order_relaxed) - beginAllocations;
+    opsCnt += ops;
+}
+
+void Measurement::report(const char* operation, size_t rssBytes)
+{
+    std::cout << std::left << std::setw(24) << container
+              << std::right << std::setw(6) << elementSz
+              << std::setw(10) << count
+              << "  " << std::left << std::setw(18) << operation
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << elapsedNs / opsCnt
+              << std::setw(12) << static_cast<double>(allocations) / opsCnt;
+    if (rssBytes != 0)
+    {
+        std::cout << std::setw(12) << static_cast<double>(rssBytes) / (1 << 20);
+    }
+    std::cout << std::endl;
+    elapsedNs = 0;
+    allocations = 0;
+    opsCnt = 0;
+}
+
+volatile size_t sink;
+
+struct IgnoreValue
+{
+    template<typename U>
+    void operator()(const U&) const {}
+};
+
+template<typename Container, typename = void>
+struct hasPrefetchedTraversal : std::false_type {};
+
+template<typename Container>
+struct hasPrefetchedTraversal<Container, std::void_t<decltype(std::declval<const Container&>().for_each_prefetched(IgnoreValue()))>> : std::true_type {};
+
+template<typename Container>
+struct hasStableIterators : std::true_type {};
+
+template<typename T, typename Allocator>
+struct hasStableIterators<UnrolledList<T, Allocator>> : std::false_type {};
+
+template<typename T, typename Container>
+void runScenario(const char* name, size_t count)
+{
+    size_t reps = std::max<size_t>(1, 1000000 / count);
+    Measurement measurement(name, sizeof(T), count);
+    std::mt19937 random(42);
+
+    size_t rssBefore = residentBytes();
+    size_t rss = 0;
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        Container container;
+        measurement.start();
+        for (size_t i = 0; i < count; ++i)
+        {
+            container.push_back(T(i));
+        }
+        measurement.stop(count);
+        if (rep == 0)
+        {
+            size_t rssAfter = residentBytes();
+            rss = rssAfter > rssBefore ? rssAfter - rssBefore : 1;
+        }
+    }
+    measurement.report("push_back", rss);
+
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        Container container;
+        measurement.start();
+        for (size_t i = 0; i < count; ++i)
+        {
+            container.push_front(T(i));
+        }
+        measurement.stop(count);
+    }
+    measurement.report("push_front");
+
+    Container source;
+    for (size_t i = 0; i < count; ++i)
+    {
+        source.push_back(T(i));
+    }
+
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        size_t sum = 0;
+        measurement.start();
+        for (const T& value : source)
+        {
+            sum += value.bytes[0];
+        }
+        measurement.stop(count);
+        sink = sum;
+    }
+    measurement.report("iterate");
+
+    if constexpr (hasPrefetchedTraversal<Container>::value)
+    {
+        for (size_t rep = 0; rep < reps; ++rep)
+        {
+            size_t sum = 0;
+            measurement.start();
+            source.for_each_prefetched([&sum](const T& value)
+            {
+                sum += value.bytes[0];
+            });
+            measurement.stop(count);
+            sink = sum;
+        }
+        measurement.report("iterate_prefetch");
+    }
+
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        measurement.start();
+        Container copy(source);
+        measurement.stop(count);
+        sink = copy.size();
+    }
+    measurement.report("copy");
+
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        auto copy = std::make_unique<Container>(source);
+        measurement.start();
+        copy.reset();
+        measurement.stop(count);
+    }
+    measurement.report("destroy");
+
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        Container copy(source);
+        measurement.start();
+        for (size_t i = 0; i < count; ++i)
+        {
+            copy.pop_back();
+        }
+        measurement.stop(count);
+    }
+    measurement.report("pop_back");
+
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        Container copy(source);
+        measurement.start();
+        for (size_t i = 0; i < count; ++i)
+        {
+            copy.pop_front();
+        }
+        measurement.stop(count);
+    }
+    measurement.report("pop_front");
+
+    if constexpr (!hasStableIterators<Container>::value)
+    {
+        return;
+    }
+    Measurement insertMeasurement(name, sizeof(T), count);
+    std::vector<typename Container::iterator> positions;
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        Container copy(source);
+        positions.clear();
+        for (auto it = copy.begin(); it != copy.end(); ++it)
+        {
+            positions.push_back(it);
+        }
+        std::shuffle(positions.begin(), positions.end(), random);
+        size_t half = count / 2;
+
+        measurement.start();
+        for (size_t i = 0; i < half; ++i)
+        {
+            copy.erase(positions[i]);
+        }
+        measurement.stop(half);
+
+        insertMeasurement.start();
+        for (size_t i = half; i < count; ++i)
+        {
+            copy.insert(positions[i], T(i));
+        }
+        insertMeasurement.stop(count - half);
+    }
+    measurement.report("random_erase");
+    insertMeasurement.report("random_insert");
+}
+
+template<size_t elementSz>
+void runSize(size_t count)
+{
+    using T = Payload<elementSz>;
+    runScenario<T, List<T, FastAllocator<T>>>("List<FastAllocator>", count);
+    runScenario<T, UnrolledList<T>>("UnrolledList", count);
+    runScenario<T, List<T, std::allocator<T>>>("List<std::allocator>", count);
+    runScenario<T, std::list<T>>("std::list", count);
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const size_t memoryLimit = size_t(1) << 30;
+
+    std::cout << std::left << std::setw(24) << "container"
+              << std::right << std::setw(6) << "bytes"
+              << std::setw(10) << "count"
+              << "  " << std::left << std::setw(18) << "operation"
+              << std::right << std::setw(10) << "ns/op"
+              << std::setw(12) << "allocs/op"
+              << std::setw(12) << "rss MiB" << std::endl;
+
+    for (size_t count = 10; count <= maxCount; count *= 10)
+    {
+        runSize<8>(count);
+        runSize<64>(count);
+        if (count * 256 <= memoryLimit)
+        {
+            runSize<256>(count);
+        }
+    }
+}
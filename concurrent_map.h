@@ -0,0 +1,277 @@
+#pragma once
+
+#include "unordered_map.h"
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+const size_t defaultShardsCnt = 64;
+const size_t shardAlignment = 64;
+
+class SharedSpinLock
+{
+public:
+    void lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+private:
+    static constexpr uint32_t writerBit = uint32_t(1) << 31;
+
+    std::atomic<uint32_t> state{0};
+};
+
+inline void SharedSpinLock::lock()
+{
+    while (state.fetch_or(writerBit, std::memory_order_acquire) & writerBit)
+    {
+        while (state.load(std::memory_order_relaxed) & writerBit)
+        {
+            std::this_thread::yield();
+        }
+    }
+    while (state.load(std::memory_order_acquire) != writerBit)
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline void SharedSpinLock::unlock()
+{
+    state.fetch_and(~writerBit, std::memory_order_release);
+}
+
+inline void SharedSpinLock::lock_shared()
+{
+    while (state.fetch_add(1, std::memory_order_acquire) & writerBit)
+    {
+        state.fetch_sub(1, std::memory_order_relaxed);
+        while (state.load(std::memory_order_relaxed) & writerBit)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+inline void SharedSpinLock::unlock_shared()
+{
+    state.fetch_sub(1, std::memory_order_release);
+}
+
+//////////////////////////////////////////
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Value>>>
+class ConcurrentUnorderedMap
+{
+public:
+    using ShardMap = UnorderedMap<Key, Value, Hash, Equal, Alloc>;
+    using NodeType = typename ShardMap::NodeType;
+    using ListNode = typename ShardMap::ListNode;
+
+    explicit ConcurrentUnorderedMap(size_t shardsCount = defaultShardsCnt);
+    ConcurrentUnorderedMap(const ConcurrentUnorderedMap&) = delete;
+    ConcurrentUnorderedMap& operator=(const ConcurrentUnorderedMap&) = delete;
+    ~ConcurrentUnorderedMap() = default;
+
+    bool find(const Key& key, Value& out) const;
+    bool contains(const Key& key) const;
+    template<typename V>
+    bool insert(const Key& key, V&& value);
+    template<typename V>
+    bool insert_or_assign(const Key& key, V&& value);
+    bool erase(const Key& key);
+
+    template<typename Func>
+    bool visit(const Key& key, Func func);
+    template<typename Func>
+    bool cvisit(const Key& key, Func func) const;
+    template<typename Func>
+    void visit_all(Func func);
+    template<typename Func>
+    void cvisit_all(Func func) const;
+
+    void reserve(size_t count);
+    size_t size() const;
+    size_t shards_count() const;
+
+private:
+    struct alignas(shardAlignment) Shard
+    {
+        mutable SharedSpinLock lock;
+        ShardMap map;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardMask;
+    Hash hashFunction;
+
+    Shard& shardFor(size_t hash) const;
+};
+
+//////////////////////////////////////////
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::ConcurrentUnorderedMap(size_t shardsCount)
+{
+    size_t count = 1;
+    while (count < shardsCount)
+    {
+        count *= 2;
+    }
+    shards.reset(new Shard[count]);
+    shardMask = count - 1;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::Shard& ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::shardFor(size_t hash) const
+{
+    return shards[static_cast<size_t>(mixBucketHash(hash) >> 32) & shardMask];
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::find(const Key& key, Value& out) const
+{
+    return cvisit(key, [&out](const Value& value)
+    {
+        out = value;
+    });
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::contains(const Key& key) const
+{
+    size_t hash = hashFunction(key);
+    const Shard& shard = shardFor(hash);
+    std::shared_lock<SharedSpinLock> guard(shard.lock);
+    return shard.map.findNode(key, hash) != nullptr;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename V>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::insert(const Key& key, V&& value)
+{
+    size_t hash = hashFunction(key);
+    Shard& shard = shardFor(hash);
+    std::unique_lock<SharedSpinLock> guard(shard.lock);
+    return shard.map.tryEmplace(hash, key, std::forward<V>(value)).second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename V>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::insert_or_assign(const Key& key, V&& value)
+{
+    size_t hash = hashFunction(key);
+    Shard& shard = shardFor(hash);
+    std::unique_lock<SharedSpinLock> guard(shard.lock);
+    auto result = shard.map.tryEmplace(hash, key, std::forward<V>(value));
+    if (!result.second)
+    {
+        (result.first) -> second = std::forward<V>(value);
+    }
+    return result.second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::erase(const Key& key)
+{
+    size_t hash = hashFunction(key);
+    Shard& shard = shardFor(hash);
+    std::unique_lock<SharedSpinLock> guard(shard.lock);
+    ListNode* node = shard.map.findNode(key, hash);
+    if (node == nullptr)
+    {
+        return false;
+    }
+    shard.map.erase(typename ShardMap::Iterator(typename ShardMap::ListIterator(node)));
+    return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Func>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::visit(const Key& key, Func func)
+{
+    size_t hash = hashFunction(key);
+    Shard& shard = shardFor(hash);
+    std::unique_lock<SharedSpinLock> guard(shard.lock);
+    ListNode* node = shard.map.findNode(key, hash);
+    if (node == nullptr)
+    {
+        return false;
+    }
+    func(node -> value.second);
+    return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Func>
+bool ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::cvisit(const Key& key, Func func) const
+{
+    size_t hash = hashFunction(key);
+    const Shard& shard = shardFor(hash);
+    std::shared_lock<SharedSpinLock> guard(shard.lock);
+    ListNode* node = shard.map.findNode(key, hash);
+    if (node == nullptr)
+    {
+        return false;
+    }
+    func(static_cast<const Value&>(node -> value.second));
+    return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Func>
+void ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::visit_all(Func func)
+{
+    for (size_t i = 0; i <= shardMask; ++i)
+    {
+        std::unique_lock<SharedSpinLock> guard(shards[i].lock);
+        for (NodeType& node : shards[i].map)
+        {
+            func(node);
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Func>
+void ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::cvisit_all(Func func) const
+{
+    for (size_t i = 0; i <= shardMask; ++i)
+    {
+        std::shared_lock<SharedSpinLock> guard(shards[i].lock);
+        for (const NodeType& node : shards[i].map)
+        {
+            func(node);
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::reserve(size_t count)
+{
+    for (size_t i = 0; i <= shardMask; ++i)
+    {
+        std::unique_lock<SharedSpinLock> guard(shards[i].lock);
+        shards[i].map.reserve(count / (shardMask + 1) + 1);
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::size() const
+{
+    size_t total = 0;
+    for (size_t i = 0; i <= shardMask; ++i)
+    {
+        std::shared_lock<SharedSpinLock> guard(shards[i].lock);
+        total += shards[i].map.size();
+    }
+    return total;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t ConcurrentUnorderedMap<Key, Value, Hash, Equal, Alloc>::shards_count() const
+{
+    return shardMask + 1;
+}
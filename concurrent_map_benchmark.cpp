@@ -0,0 +1,134 @@
+// g++ -std=c++17 -O2 -DNDEBUG -pthread concurrent_map_benchmark.cpp -o concurrent_map_benchmark && ./concurrent_map_benchmark [maxThreads]
+
+#include "concurrent_map.h"
+#include "rcu_map.h"
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <iostream>
+#include <iomanip>
+
+const size_t keysCnt = 1 << 16;
+const size_t opsPerThread = 1 << 19;
+
+class GlobalLockedMap
+{
+public:
+    bool find(uint64_t key, uint64_t& out) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return false;
+        }
+        out = (*it).second;
+        return true;
+    }
+
+    void insert_or_assign(uint64_t key, uint64_t value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        map[key] = value;
+    }
+
+    bool erase(uint64_t key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = map.find(key);
+        if (it == map.end())
+        {
+            return false;
+        }
+        map.erase(it);
+        return true;
+    }
+
+private:
+    mutable std::mutex lock;
+    UnorderedMap<uint64_t, uint64_t> map;
+};
+
+template<typename Map>
+double runWorkload(Map& map, size_t threadsCnt, size_t writePercent)
+{
+    std::atomic<bool> start{false};
+    std::atomic<size_t> sink{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadsCnt; ++t)
+    {
+        threads.emplace_back([&map, &start, &sink, t, writePercent]()
+        {
+            std::mt19937_64 random(t + 1);
+            size_t found = 0;
+            while (!start.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < opsPerThread; ++i)
+            {
+                uint64_t value = random();
+                uint64_t key = value % keysCnt;
+                if (value / keysCnt % 100 >= writePercent)
+                {
+                    uint64_t out;
+                    found += map.find(key, out);
+                }
+                else if (value & (uint64_t(1) << 63))
+                {
+                    map.insert_or_assign(key, value);
+                }
+                else
+                {
+                    map.erase(key);
+                }
+            }
+            sink.fetch_add(found, std::memory_order_relaxed);
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    return threadsCnt * opsPerThread / seconds / 1e6;
+}
+
+template<typename Map>
+void runScaling(const char* name, size_t maxThreads, size_t writePercent)
+{
+    for (size_t threadsCnt = 1; threadsCnt <= maxThreads; threadsCnt *= 2)
+    {
+        Map map;
+        for (uint64_t key = 0; key < keysCnt; key += 2)
+        {
+            map.insert_or_assign(key, key);
+        }
+        double mops = runWorkload(map, threadsCnt, writePercent);
+        std::cout << std::left << std::setw(26) << name
+                  << std::right << std::setw(8) << writePercent
+                  << std::setw(10) << threadsCnt
+                  << std::fixed << std::setprecision(2) << std::setw(12) << mops << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxThreads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(26) << "map"
+              << std::right << std::setw(8) << "write%"
+              << std::setw(10) << "threads"
+              << std::setw(12) << "Mops/s" << std::endl;
+
+    for (size_t writePercent : {0, 5, 50})
+    {
+        runScaling<GlobalLockedMap>("UnorderedMap+mutex", maxThreads, writePercent);
+        runScaling<ConcurrentUnorderedMap<uint64_t, uint64_t>>("ConcurrentUnorderedMap", maxThreads, writePercent);
+        runScaling<RcuHashMap<uint64_t, uint64_t>>("RcuHashMap", maxThreads, writePercent);
+    }
+}
@@ -0,0 +1,412 @@
+#pragma once
+
+#include "fastallocator.h"
+
+static_assert(sizeof(void*) == 8, "LockFreeQueue packs an ABA tag into the upper pointer bits");
+
+template<typename T>
+class LockFreeQueue
+{
+private:
+    struct Node
+    {
+        std::atomic<int> refsCnt;
+        std::atomic<uint64_t> next;
+        std::atomic<Node*> nextFree;
+        alignas(T) int8_t storage[sizeof(T)];
+
+        T* value();
+    };
+
+    static constexpr int tagShift = 48;
+    static constexpr uint64_t pointerMask = (uint64_t(1) << tagShift) - 1;
+
+    static uint64_t pack(Node* node, uint64_t tag);
+    static Node* nodeOf(uint64_t tagged);
+    static uint64_t tagOf(uint64_t tagged);
+
+    ConcurrentFixedAllocator<sizeof(Node), alignof(Node)> pool;
+    alignas(cacheLineSz) std::atomic<uint64_t> head;
+    alignas(cacheLineSz) std::atomic<uint64_t> tail;
+    alignas(cacheLineSz) std::atomic<uint64_t> freeHead;
+
+    Node* popFree();
+    void pushFree(Node* node);
+    Node* makeNode();
+    void release(Node* node);
+    void link(Node* node);
+
+public:
+    LockFreeQueue();
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+    ~LockFreeQueue();
+
+    void push(const T& value);
+    void push(T&& value);
+    template<typename... Args>
+    void emplace(Args&&... args);
+    bool try_pop(T& out);
+    bool empty() const;
+};
+
+template<typename T>
+class BoundedQueue
+{
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+                  "BoundedQueue moves values in and out of claimed cells, which cannot be given back");
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) int8_t storage[sizeof(T)];
+
+        T* value();
+    };
+
+    Cell* cells;
+    size_t mask;
+    alignas(cacheLineSz) std::atomic<size_t> enqueuePos;
+    alignas(cacheLineSz) std::atomic<size_t> dequeuePos;
+
+public:
+    explicit BoundedQueue(size_t capacity);
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    ~BoundedQueue();
+
+    bool try_push(const T& value);
+    bool try_push(T&& value);
+    template<typename... Args>
+    bool try_emplace(Args&&... args);
+    bool try_pop(T& out);
+    size_t capacity() const;
+};
+
+//////////////////////////////////////////
+template<typename T>
+T* LockFreeQueue<T>::Node::value()
+{
+    return reinterpret_cast<T*>(storage);
+}
+
+template<typename T>
+uint64_t LockFreeQueue<T>::pack(Node* node, uint64_t tag)
+{
+    return reinterpret_cast<uint64_t>(node) | (tag << tagShift);
+}
+
+template<typename T>
+typename LockFreeQueue<T>::Node* LockFreeQueue<T>::nodeOf(uint64_t tagged)
+{
+    return reinterpret_cast<Node*>(tagged & pointerMask);
+}
+
+template<typename T>
+uint64_t LockFreeQueue<T>::tagOf(uint64_t tagged)
+{
+    return tagged >> tagShift;
+}
+
+template<typename T>
+typename LockFreeQueue<T>::Node* LockFreeQueue<T>::popFree()
+{
+    uint64_t first = freeHead.load(std::memory_order_acquire);
+    while (nodeOf(first) != nullptr)
+    {
+        Node* next = nodeOf(first) -> nextFree.load(std::memory_order_relaxed);
+        if (freeHead.compare_exchange_weak(first, pack(next, tagOf(first) + 1), std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return nodeOf(first);
+        }
+    }
+    return nullptr;
+}
+
+template<typename T>
+void LockFreeQueue<T>::pushFree(Node* node)
+{
+    uint64_t first = freeHead.load(std::memory_order_relaxed);
+    do
+    {
+        node -> nextFree.store(nodeOf(first), std::memory_order_relaxed);
+    }
+    while (!freeHead.compare_exchange_weak(first, pack(node, tagOf(first) + 1), std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<typename T>
+typename LockFreeQueue<T>::Node* LockFreeQueue<T>::makeNode()
+{
+    Node* node = popFree();
+    if (node == nullptr)
+    {
+        node = new(pool.allocate()) Node;
+        node -> next.store(0, std::memory_order_relaxed);
+    }
+    uint64_t oldNext = node -> next.load(std::memory_order_relaxed);
+    node -> next.store(pack(nullptr, tagOf(oldNext) + 1), std::memory_order_relaxed);
+    node -> refsCnt.store(2, std::memory_order_relaxed);
+    return node;
+}
+
+template<typename T>
+void LockFreeQueue<T>::release(Node* node)
+{
+    if (node -> refsCnt.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        pushFree(node);
+    }
+}
+
+template<typename T>
+LockFreeQueue<T>::LockFreeQueue()
+{
+    freeHead.store(0, std::memory_order_relaxed);
+    Node* dummy = makeNode();
+    dummy -> refsCnt.store(1, std::memory_order_relaxed);
+    head.store(pack(dummy, 0), std::memory_order_relaxed);
+    tail.store(pack(dummy, 0), std::memory_order_relaxed);
+}
+
+template<typename T>
+LockFreeQueue<T>::~LockFreeQueue()
+{
+    Node* dummy = nodeOf(head.load(std::memory_order_relaxed));
+    Node* node = nodeOf(dummy -> next.load(std::memory_order_relaxed));
+    pool.deallocate(dummy);
+    while (node != nullptr)
+    {
+        Node* next = nodeOf(node -> next.load(std::memory_order_relaxed));
+        node -> value() -> ~T();
+        pool.deallocate(node);
+        node = next;
+    }
+    node = nodeOf(freeHead.load(std::memory_order_relaxed));
+    while (node != nullptr)
+    {
+        Node* next = node -> nextFree.load(std::memory_order_relaxed);
+        pool.deallocate(node);
+        node = next;
+    }
+}
+
+template<typename T>
+void LockFreeQueue<T>::link(Node* node)
+{
+    uint64_t last;
+    while (true)
+    {
+        last = tail.load(std::memory_order_acquire);
+        uint64_t next = nodeOf(last) -> next.load(std::memory_order_acquire);
+        if (last != tail.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        if (nodeOf(next) == nullptr)
+        {
+            if (nodeOf(last) -> next.compare_exchange_weak(next, pack(node, tagOf(next) + 1), std::memory_order_release, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else
+        {
+            tail.compare_exchange_weak(last, pack(nodeOf(next), tagOf(last) + 1), std::memory_order_release, std::memory_order_relaxed);
+        }
+    }
+    tail.compare_exchange_strong(last, pack(node, tagOf(last) + 1), std::memory_order_release, std::memory_order_relaxed);
+}
+
+template<typename T>
+void LockFreeQueue<T>::push(const T& value)
+{
+    emplace(value);
+}
+
+template<typename T>
+void LockFreeQueue<T>::push(T&& value)
+{
+    emplace(std::move(value));
+}
+
+template<typename T>
+template<typename... Args>
+void LockFreeQueue<T>::emplace(Args&&... args)
+{
+    Node* node = makeNode();
+    try
+    {
+        new(node -> value()) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        pushFree(node);
+        throw;
+    }
+    link(node);
+}
+
+template<typename T>
+bool LockFreeQueue<T>::try_pop(T& out)
+{
+    while (true)
+    {
+        uint64_t first = head.load(std::memory_order_acquire);
+        uint64_t last = tail.load(std::memory_order_acquire);
+        uint64_t next = nodeOf(first) -> next.load(std::memory_order_acquire);
+        if (first != head.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        if (nodeOf(first) == nodeOf(last))
+        {
+            if (nodeOf(next) == nullptr)
+            {
+                return false;
+            }
+            tail.compare_exchange_weak(last, pack(nodeOf(next), tagOf(last) + 1), std::memory_order_release, std::memory_order_relaxed);
+            continue;
+        }
+        if (head.compare_exchange_weak(first, pack(nodeOf(next), tagOf(first) + 1), std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            Node* node = nodeOf(next);
+            out = std::move(*node -> value());
+            node -> value() -> ~T();
+            release(node);
+            release(nodeOf(first));
+            return true;
+        }
+    }
+}
+
+template<typename T>
+bool LockFreeQueue<T>::empty() const
+{
+    uint64_t first = head.load(std::memory_order_acquire);
+    return nodeOf(nodeOf(first) -> next.load(std::memory_order_acquire)) == nullptr;
+}
+
+//////////////////////////////////////////
+template<typename T>
+T* BoundedQueue<T>::Cell::value()
+{
+    return reinterpret_cast<T*>(storage);
+}
+
+template<typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    mask = size - 1;
+    cells = reinterpret_cast<Cell*>(operator new(size * sizeof(Cell), std::align_val_t(alignof(Cell))));
+    for (size_t i = 0; i < size; ++i)
+    {
+        new(&cells[i].sequence) std::atomic<size_t>(i);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+template<typename T>
+BoundedQueue<T>::~BoundedQueue()
+{
+    size_t first = dequeuePos.load(std::memory_order_relaxed);
+    size_t last = enqueuePos.load(std::memory_order_relaxed);
+    for (size_t pos = first; pos != last; ++pos)
+    {
+        cells[pos & mask].value() -> ~T();
+    }
+    operator delete(cells, std::align_val_t(alignof(Cell)));
+}
+
+template<typename T>
+bool BoundedQueue<T>::try_push(const T& value)
+{
+    return try_emplace(value);
+}
+
+template<typename T>
+bool BoundedQueue<T>::try_push(T&& value)
+{
+    return try_emplace(std::move(value));
+}
+
+template<typename T>
+template<typename... Args>
+bool BoundedQueue<T>::try_emplace(Args&&... args)
+{
+    if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>)
+    {
+        T value(std::forward<Args>(args)...);
+        return try_emplace(std::move(value));
+    }
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+        cell = &cells[pos & mask];
+        size_t sequence = cell -> sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    new(cell -> value()) T(std::forward<Args>(args)...);
+    cell -> sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+bool BoundedQueue<T>::try_pop(T& out)
+{
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true)
+    {
+        cell = &cells[pos & mask];
+        size_t sequence = cell -> sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    out = std::move(*cell -> value());
+    cell -> value() -> ~T();
+    cell -> sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+size_t BoundedQueue<T>::capacity() const
+{
+    return mask + 1;
+}
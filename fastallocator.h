@@ -1,87 +1,960 @@
+#pragma once
+
 #include <iostream>
 #include <memory>
 #include <vector>
 #include <type_traits>
 #include <cassert>
 #include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <cstring>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory_resource>
+#include <tuple>
+#include <fstream>
+#include <string>
+#include <typeinfo>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#endif
+
+const size_t defaultFirstBlockSz = 512;
+const size_t defaultMaxBlockSz = 1 << 16;
+const size_t hugePageSz = 2 << 20;
+const size_t cacheLineSz = 64;
+const size_t defaultPrefetchDistance = 8;
+const size_t numaNodeRefreshPeriod = 1024;
+
+#ifdef FASTALLOCATOR_STATS
+#define FASTALLOCATOR_STAT(expr) expr
+#else
+#define FASTALLOCATOR_STAT(expr)
+#endif
+
+#ifdef FASTALLOCATOR_HARDENED
+const size_t guardSz = sizeof(uint64_t);
+const uint64_t guardCanary = 0xC0DEFACEC0DEFACEull;
+const uint8_t poisonByte = 0xDD;
+#else
+const size_t guardSz = 0;
+#endif
+
+inline const std::vector<size_t>& numaOnlineNodes()
+{
+    static const std::vector<size_t> nodes = []()
+    {
+        std::vector<size_t> result;
+#ifdef __linux__
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string ranges;
+        if (online >> ranges)
+        {
+            const char* pos = ranges.c_str();
+            while (*pos != '\0')
+            {
+                char* end = nullptr;
+                size_t first = std::strtoul(pos, &end, 10);
+                if (end == pos)
+                {
+                    break;
+                }
+                size_t last = first;
+                if (*end == '-')
+                {
+                    last = std::strtoul(end + 1, &end, 10);
+                }
+                for (size_t node = first; node <= last; ++node)
+                {
+                    result.push_back(node);
+                }
+                pos = (*end == ',') ? end + 1 : end;
+            }
+        }
+#endif
+        if (result.empty())
+        {
+            result.push_back(0);
+        }
+        return result;
+    }();
+    return nodes;
+}
+
+inline size_t numaNodesCount()
+{
+    return numaOnlineNodes().size();
+}
+
+inline size_t currentNumaNode()
+{
+#ifdef __linux__
+    thread_local unsigned node = 0;
+    thread_local size_t callsLeft = 0;
+    if (callsLeft == 0)
+    {
+        unsigned cpu = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+        {
+            node = 0;
+        }
+        callsLeft = numaNodeRefreshPeriod;
+    }
+    --callsLeft;
+    return node;
+#else
+    return 0;
+#endif
+}
+
+inline void prefetchRead(const void* ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr, 0, 3);
+#endif
+}
+
+struct AllocatorStats
+{
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t liveChunks = 0;
+    size_t peakChunks = 0;
+    size_t blocks = 0;
+    size_t fallbacks = 0;
+    size_t paddingBytes = 0;
+};
 
-template <size_t chunkSize>
+template <size_t chunkSize, size_t chunkAlign = alignof(std::max_align_t), bool cacheLineAligned = false>
 struct FixedAllocator
 {
 public:
-    struct Chunk
+    static constexpr size_t chunkAlignment = std::max(cacheLineAligned ? cacheLineSz : alignof(void*), chunkAlign);
+
+    union alignas(chunkAlignment) Chunk
     {
-        int8_t data[chunkSize];
+        int8_t data[chunkSize + guardSz];
         Chunk* nextFree;
     };
 
-    FixedAllocator();
+    explicit FixedAllocator(size_t firstBlockSz = defaultFirstBlockSz, size_t maxBlockSz = defaultMaxBlockSz, bool useHugePages = false);
+    FixedAllocator(const FixedAllocator&) = delete;
+    FixedAllocator& operator=(const FixedAllocator&) = delete;
+    FixedAllocator(FixedAllocator&& another) noexcept;
+    FixedAllocator& operator=(FixedAllocator&& another) noexcept;
     ~FixedAllocator();
+    void swap(FixedAllocator& another) noexcept;
 
     void* allocate();
     void deallocate(void* ptr);
+    void allocateBatch(void** out, size_t count);
+    void deallocateBatch(void** ptrs, size_t count);
+
+    size_t trim(size_t keepFreeChunks = 0);
+    void setAutoTrim(size_t maxFreeChunks);
+    void bindToNode(int node);
+    void setUpstream(std::pmr::memory_resource* resource);
+    bool owns(const void* ptr);
+    size_t liveChunks() const;
+    size_t freeChunks() const;
+    size_t blocksCount() const;
+    AllocatorStats stats() const;
 
 private:
-    std::vector<Chunk*> blocks;
-    Chunk* freeMemory;
-    size_t blockSz = 512;
+    struct Block
+    {
+        Chunk* begin;
+        size_t size;
+        size_t bytes;
+        bool mapped;
+        size_t used = 0;
+        bool released = false;
+#ifdef FASTALLOCATOR_HARDENED
+        std::vector<uint64_t> allocatedMap = {};
+#endif
+    };
+
+    std::vector<Block> blocks;
+    Chunk* freeMemory = nullptr;
+    size_t blockSz;
+    size_t maxBlockSz;
+    bool useHugePages;
+    size_t liveCnt = 0;
+    size_t freeCnt = 0;
+    size_t autoTrimLimit = 0;
+    int numaNode = -1;
+    std::pmr::memory_resource* upstream = nullptr;
+#ifdef FASTALLOCATOR_STATS
+    size_t allocationsCnt = 0;
+    size_t deallocationsCnt = 0;
+    size_t peakCnt = 0;
+#endif
 
     void addBlock();
+    Block* findBlock(const Chunk* chunk);
+    bool tracksBlocks() const;
+    void countUsed();
+    Chunk* popChunk();
+    bool pushChunk(Chunk* chunk);
+    Block allocateBlock(size_t count);
+    void releaseBlock(const Block& block);
+#ifdef FASTALLOCATOR_HARDENED
+    void checkAllocated(Chunk* chunk, Block* block);
+    void checkFree(Chunk* chunk);
+    static void reportCorruption(const char* what, const void* ptr);
+#endif
 };
 
-template <size_t chunkSize>
-void FixedAllocator<chunkSize>::addBlock()
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+typename FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::Block FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocateBlock(size_t count)
 {
-    auto* block = new Chunk[blockSz];
-    for (size_t i = 0; i < blockSz - 1; ++i)
+    size_t bytes = count * sizeof(Chunk);
+#ifdef __linux__
+    bool huge = useHugePages && bytes >= hugePageSz;
+    if (huge || numaNode >= 0)
+    {
+        size_t pageSz = huge ? hugePageSz : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        bytes = (bytes + pageSz - 1) / pageSz * pageSz;
+        size_t mapBytes = huge ? bytes + hugePageSz : bytes;
+        void* raw = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw != MAP_FAILED)
+        {
+            uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+            uintptr_t aligned = (start + pageSz - 1) / pageSz * pageSz;
+            if (aligned != start)
+            {
+                munmap(raw, aligned - start);
+            }
+            if (aligned + bytes != start + mapBytes)
+            {
+                munmap(reinterpret_cast<void*>(aligned + bytes), start + mapBytes - aligned - bytes);
+            }
+            void* memory = reinterpret_cast<void*>(aligned);
+            if (huge)
+            {
+                madvise(memory, bytes, MADV_HUGEPAGE);
+            }
+            if (numaNode >= 0)
+            {
+                std::vector<unsigned long> nodeMask(numaNode / (8 * sizeof(unsigned long)) + 1, 0);
+                nodeMask[numaNode / (8 * sizeof(unsigned long))] |= 1ul << (numaNode % (8 * sizeof(unsigned long)));
+                syscall(SYS_mbind, memory, bytes, MPOL_PREFERRED, nodeMask.data(), nodeMask.size() * 8 * sizeof(unsigned long) + 1, 0);
+            }
+            return {reinterpret_cast<Chunk*>(memory), bytes / sizeof(Chunk), bytes, true};
+        }
+    }
+#endif
+    if (upstream != nullptr)
     {
-        block[i].nextFree = block + i + 1;
+        return {reinterpret_cast<Chunk*>(upstream -> allocate(bytes, alignof(Chunk))), count, bytes, false};
     }
-    block[blockSz - 1].nextFree = nullptr;
-    blocks.push_back(block);
-    freeMemory = blocks[blocks.size() - 1];
+    return {reinterpret_cast<Chunk*>(operator new(bytes, std::align_val_t(alignof(Chunk)))), count, bytes, false};
 }
 
-template <size_t chunkSize>
-FixedAllocator<chunkSize>::FixedAllocator()
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::releaseBlock(const Block& block)
 {
-    addBlock();
+#ifdef __linux__
+    if (block.mapped)
+    {
+        munmap(block.begin, block.bytes);
+        return;
+    }
+#endif
+    if (upstream != nullptr)
+    {
+        upstream -> deallocate(block.begin, block.bytes, alignof(Chunk));
+        return;
+    }
+    operator delete(block.begin, std::align_val_t(alignof(Chunk)));
 }
 
-template <size_t chunkSize>
-FixedAllocator<chunkSize>::~FixedAllocator()
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::addBlock()
 {
-    for (auto ptr : blocks)
+    Block block = allocateBlock(blockSz);
+    Chunk* chunks = block.begin;
+#ifdef FASTALLOCATOR_HARDENED
+    std::memset(chunks, poisonByte, block.size * sizeof(Chunk));
+    block.allocatedMap.assign((block.size + 63) / 64, 0);
+#endif
+    for (size_t i = 0; i < block.size - 1; ++i)
     {
-        delete ptr;
+        chunks[i].nextFree = chunks + i + 1;
     }
+    chunks[block.size - 1].nextFree = freeMemory;
+    freeMemory = chunks;
+    freeCnt += block.size;
+    auto pos = std::lower_bound(blocks.begin(), blocks.end(), block, [](const Block& a, const Block& b)
+    {
+        return a.begin < b.begin;
+    });
+    blocks.insert(pos, std::move(block));
+    blockSz = std::min(2 * blockSz, maxBlockSz);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::FixedAllocator(size_t firstBlockSz, size_t maxBlockSz, bool useHugePages) :
+        blockSz(std::max<size_t>(firstBlockSz, 1)),
+        maxBlockSz(std::max(maxBlockSz, blockSz)),
+        useHugePages(useHugePages) {}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::FixedAllocator(FixedAllocator&& another) noexcept :
+        blockSz(another.blockSz),
+        maxBlockSz(another.maxBlockSz),
+        useHugePages(another.useHugePages)
+{
+    swap(another);
 }
 
-template <size_t chunkSize>
-void* FixedAllocator<chunkSize>::allocate()
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>& FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::operator=(FixedAllocator&& another) noexcept
 {
+    swap(another);
+    return *this;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::swap(FixedAllocator& another) noexcept
+{
+    std::swap(blocks, another.blocks);
+    std::swap(freeMemory, another.freeMemory);
+    std::swap(blockSz, another.blockSz);
+    std::swap(maxBlockSz, another.maxBlockSz);
+    std::swap(useHugePages, another.useHugePages);
+    std::swap(liveCnt, another.liveCnt);
+    std::swap(freeCnt, another.freeCnt);
+    std::swap(autoTrimLimit, another.autoTrimLimit);
+    std::swap(numaNode, another.numaNode);
+    std::swap(upstream, another.upstream);
+#ifdef FASTALLOCATOR_STATS
+    std::swap(allocationsCnt, another.allocationsCnt);
+    std::swap(deallocationsCnt, another.deallocationsCnt);
+    std::swap(peakCnt, another.peakCnt);
+#endif
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::~FixedAllocator()
+{
+    for (const Block& block : blocks)
+    {
+        releaseBlock(block);
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+typename FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::Chunk* FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::popChunk()
+{
+#ifdef FASTALLOCATOR_HARDENED
+    checkFree(freeMemory);
+#endif
     Chunk* memory = freeMemory;
-    if (freeMemory -> nextFree != nullptr)
+    freeMemory = freeMemory -> nextFree;
+    if (tracksBlocks())
     {
-        freeMemory = freeMemory -> nextFree;
+        Block* block = findBlock(memory);
+#ifdef FASTALLOCATOR_HARDENED
+        size_t index = memory - block -> begin;
+        block -> allocatedMap[index / 64] |= uint64_t(1) << (index % 64);
+        std::memcpy(memory -> data + chunkSize, &guardCanary, guardSz);
+#endif
+        block -> used++;
     }
-    else
+    return memory;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+bool FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::pushChunk(Chunk* chunk)
+{
+    Block* block = nullptr;
+    if (tracksBlocks())
+    {
+        block = findBlock(chunk);
+#ifdef FASTALLOCATOR_HARDENED
+        checkAllocated(chunk, block);
+        std::memset(chunk, poisonByte, sizeof(Chunk));
+#endif
+    }
+    assert(findBlock(chunk) != nullptr);
+    chunk -> nextFree = freeMemory;
+    freeMemory = chunk;
+    return block != nullptr && --block -> used == 0;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+bool FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::tracksBlocks() const
+{
+#ifdef FASTALLOCATOR_HARDENED
+    return true;
+#else
+    return autoTrimLimit != 0;
+#endif
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::countUsed()
+{
+    for (Block& block : blocks)
+    {
+        block.used = block.size;
+    }
+    for (Chunk* chunk = freeMemory; chunk != nullptr; chunk = chunk -> nextFree)
+    {
+        findBlock(chunk) -> used--;
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void* FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocate()
+{
+    if (freeMemory == nullptr)
     {
         addBlock();
     }
+    Chunk* memory = popChunk();
+    liveCnt++;
+    freeCnt--;
+    FASTALLOCATOR_STAT(allocationsCnt++);
+    FASTALLOCATOR_STAT(peakCnt = std::max(peakCnt, liveCnt));
     return reinterpret_cast<void*>(memory);
 }
 
-template <size_t chunkSize>
-void FixedAllocator<chunkSize>::deallocate(void* ptr)
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::deallocate(void* ptr)
+{
+    bool blockEmptied = pushChunk(reinterpret_cast<Chunk*> (ptr));
+    liveCnt--;
+    freeCnt++;
+    FASTALLOCATOR_STAT(deallocationsCnt++);
+    if (autoTrimLimit != 0 && blockEmptied && freeCnt > autoTrimLimit)
+    {
+        trim(autoTrimLimit);
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocateBatch(void** out, size_t count)
+{
+    while (freeCnt < count)
+    {
+        addBlock();
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = reinterpret_cast<void*>(popChunk());
+    }
+    liveCnt += count;
+    freeCnt -= count;
+    FASTALLOCATOR_STAT(allocationsCnt += count);
+    FASTALLOCATOR_STAT(peakCnt = std::max(peakCnt, liveCnt));
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::deallocateBatch(void** ptrs, size_t count)
 {
-    Chunk* newFreeMemory = reinterpret_cast<Chunk*> (ptr);
-    newFreeMemory -> nextFree = freeMemory;
-    freeMemory = newFreeMemory;
+    bool blockEmptied = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        blockEmptied |= pushChunk(reinterpret_cast<Chunk*>(ptrs[i]));
+    }
+    liveCnt -= count;
+    freeCnt += count;
+    FASTALLOCATOR_STAT(deallocationsCnt += count);
+    if (autoTrimLimit != 0 && blockEmptied && freeCnt > autoTrimLimit)
+    {
+        trim(autoTrimLimit);
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+typename FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::Block* FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::findBlock(const Chunk* chunk)
+{
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), chunk, [](const Chunk* ptr, const Block& block)
+    {
+        return ptr < block.begin;
+    });
+    if (it == blocks.begin())
+    {
+        return nullptr;
+    }
+    --it;
+    if (chunk >= it -> begin + it -> size)
+    {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+#ifdef FASTALLOCATOR_HARDENED
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::reportCorruption(const char* what, const void* ptr)
+{
+    std::cerr << "FixedAllocator: " << what << " at " << ptr << std::endl;
+    std::abort();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::checkAllocated(Chunk* chunk, Block* block)
+{
+    if (block == nullptr)
+    {
+        reportCorruption("foreign pointer freed", chunk);
+    }
+    uintptr_t offset = reinterpret_cast<uintptr_t>(chunk) - reinterpret_cast<uintptr_t>(block -> begin);
+    if (offset % sizeof(Chunk) != 0)
+    {
+        reportCorruption("misaligned pointer freed", chunk);
+    }
+    size_t index = offset / sizeof(Chunk);
+    uint64_t bit = uint64_t(1) << (index % 64);
+    if ((block -> allocatedMap[index / 64] & bit) == 0)
+    {
+        reportCorruption("double free", chunk);
+    }
+    block -> allocatedMap[index / 64] &= ~bit;
+    if (std::memcmp(chunk -> data + chunkSize, &guardCanary, guardSz) != 0)
+    {
+        reportCorruption("guard canary overwritten", chunk);
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::checkFree(Chunk* chunk)
+{
+    if (chunk -> nextFree != nullptr && findBlock(chunk -> nextFree) == nullptr)
+    {
+        reportCorruption("free list corrupted", chunk);
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(chunk);
+    for (size_t i = sizeof(Chunk*); i < sizeof(Chunk); ++i)
+    {
+        if (bytes[i] != poisonByte)
+        {
+            reportCorruption("write after free", chunk);
+        }
+    }
+}
+#endif
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::trim(size_t keepFreeChunks)
+{
+    if (!tracksBlocks())
+    {
+        countUsed();
+    }
+    size_t releasedCnt = 0;
+    size_t remainingFree = freeCnt;
+    for (auto it = blocks.rbegin(); it != blocks.rend() && remainingFree > keepFreeChunks; ++it)
+    {
+        if (it -> used == 0 && remainingFree - it -> size >= keepFreeChunks)
+        {
+            it -> released = true;
+            remainingFree -= it -> size;
+            ++releasedCnt;
+        }
+    }
+    if (releasedCnt == 0)
+    {
+        return 0;
+    }
+
+    Chunk* kept = nullptr;
+    for (Chunk* chunk = freeMemory; chunk != nullptr;)
+    {
+        Chunk* next = chunk -> nextFree;
+        if (!findBlock(chunk) -> released)
+        {
+            chunk -> nextFree = kept;
+            kept = chunk;
+        }
+        chunk = next;
+    }
+    freeMemory = kept;
+    freeCnt = remainingFree;
+
+    for (const Block& block : blocks)
+    {
+        if (block.released)
+        {
+            releaseBlock(block);
+        }
+    }
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [](const Block& block)
+    {
+        return block.released;
+    }), blocks.end());
+    return releasedCnt;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::setAutoTrim(size_t maxFreeChunks)
+{
+    bool tracked = tracksBlocks();
+    autoTrimLimit = maxFreeChunks;
+    if (!tracked && tracksBlocks())
+    {
+        countUsed();
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::bindToNode(int node)
+{
+    numaNode = node;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::setUpstream(std::pmr::memory_resource* resource)
+{
+    upstream = resource;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+bool FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::owns(const void* ptr)
+{
+    return findBlock(reinterpret_cast<const Chunk*>(ptr)) != nullptr;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::liveChunks() const
+{
+    return liveCnt;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::freeChunks() const
+{
+    return freeCnt;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::blocksCount() const
+{
+    return blocks.size();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+AllocatorStats FixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::stats() const
+{
+    AllocatorStats result;
+    result.liveChunks = liveCnt;
+    result.blocks = blocks.size();
+    result.paddingBytes = liveCnt * (sizeof(Chunk) - chunkSize);
+#ifdef FASTALLOCATOR_STATS
+    result.allocations = allocationsCnt;
+    result.deallocations = deallocationsCnt;
+    result.peakChunks = peakCnt;
+#endif
+    return result;
 }
 
 //////////////////////////////////////////////////////////
-template<typename T>
+class SpinLock
+{
+public:
+    void lock();
+    void unlock();
+
+private:
+    std::atomic<bool> locked{false};
+};
+
+inline void SpinLock::lock()
+{
+    while (locked.exchange(true, std::memory_order_acquire))
+    {
+        while (locked.load(std::memory_order_relaxed))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+inline void SpinLock::unlock()
+{
+    locked.store(false, std::memory_order_release);
+}
+
+template <size_t chunkSize, size_t chunkAlign = alignof(std::max_align_t), bool cacheLineAligned = false>
+class ConcurrentFixedAllocator
+{
+public:
+    explicit ConcurrentFixedAllocator(size_t firstBlockSz = defaultFirstBlockSz, size_t maxBlockSz = defaultMaxBlockSz, bool useHugePages = false);
+
+    void* allocate();
+    void deallocate(void* ptr);
+    void allocateBatch(void** out, size_t count);
+    void deallocateBatch(void** ptrs, size_t count);
+    size_t trim(size_t keepFreeChunks = 0);
+    void bindToNode(int node);
+    bool owns(const void* ptr);
+    AllocatorStats stats();
+
+private:
+    alignas(cacheLineSz) SpinLock lock;
+    FixedAllocator<chunkSize, chunkAlign, cacheLineAligned> fixAlloc;
+};
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::ConcurrentFixedAllocator(size_t firstBlockSz, size_t maxBlockSz, bool useHugePages) :
+        fixAlloc(firstBlockSz, maxBlockSz, useHugePages) {}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void* ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocate()
+{
+    std::lock_guard<SpinLock> guard(lock);
+    return fixAlloc.allocate();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::deallocate(void* ptr)
+{
+    std::lock_guard<SpinLock> guard(lock);
+    fixAlloc.deallocate(ptr);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocateBatch(void** out, size_t count)
+{
+    std::lock_guard<SpinLock> guard(lock);
+    fixAlloc.allocateBatch(out, count);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::deallocateBatch(void** ptrs, size_t count)
+{
+    std::lock_guard<SpinLock> guard(lock);
+    fixAlloc.deallocateBatch(ptrs, count);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::trim(size_t keepFreeChunks)
+{
+    std::lock_guard<SpinLock> guard(lock);
+    return fixAlloc.trim(keepFreeChunks);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::bindToNode(int node)
+{
+    std::lock_guard<SpinLock> guard(lock);
+    fixAlloc.bindToNode(node);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+bool ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::owns(const void* ptr)
+{
+    std::lock_guard<SpinLock> guard(lock);
+    return fixAlloc.owns(ptr);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+AllocatorStats ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::stats()
+{
+    std::lock_guard<SpinLock> guard(lock);
+    return fixAlloc.stats();
+}
+
+//////////////////////////////////////////////////////////
+template <size_t chunkSize, size_t chunkAlign = alignof(std::max_align_t), bool cacheLineAligned = false>
+class NumaFixedAllocator
+{
+public:
+    explicit NumaFixedAllocator(int boundNode = -1, size_t firstBlockSz = defaultFirstBlockSz, size_t maxBlockSz = defaultMaxBlockSz, bool useHugePages = false);
+
+    void* allocate();
+    void* allocateOnNode(size_t node);
+    void deallocate(void* ptr);
+    void allocateBatch(void** out, size_t count);
+    void deallocateBatch(void** ptrs, size_t count);
+    size_t trim(size_t keepFreeChunks = 0);
+    size_t nodesCount() const;
+    AllocatorStats stats();
+    AllocatorStats stats(size_t node);
+
+private:
+    using Pool = ConcurrentFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>;
+    std::vector<std::unique_ptr<Pool>> pools;
+    std::vector<size_t> poolOfNode;
+    int boundNode;
+
+    size_t poolIndex(size_t node) const;
+    size_t localNode() const;
+    Pool& ownerOf(const void* ptr);
+};
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::NumaFixedAllocator(int boundNode, size_t firstBlockSz, size_t maxBlockSz, bool useHugePages) :
+        boundNode(boundNode)
+{
+    const std::vector<size_t>& nodes = numaOnlineNodes();
+    poolOfNode.assign(*std::max_element(nodes.begin(), nodes.end()) + 1, 0);
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        poolOfNode[nodes[i]] = i;
+        pools.push_back(std::make_unique<Pool>(firstBlockSz, maxBlockSz, useHugePages));
+        if (nodes.size() > 1)
+        {
+            pools.back() -> bindToNode(static_cast<int>(nodes[i]));
+        }
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::poolIndex(size_t node) const
+{
+    return node < poolOfNode.size() ? poolOfNode[node] : 0;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::localNode() const
+{
+    if (pools.size() == 1)
+    {
+        return 0;
+    }
+    if (boundNode >= 0)
+    {
+        return poolIndex(static_cast<size_t>(boundNode));
+    }
+    return poolIndex(currentNumaNode());
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+typename NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::Pool& NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::ownerOf(const void* ptr)
+{
+    size_t local = localNode();
+    if (pools.size() == 1 || pools[local] -> owns(ptr))
+    {
+        return *pools[local];
+    }
+    for (size_t node = 0; node < pools.size(); ++node)
+    {
+        if (node != local && pools[node] -> owns(ptr))
+        {
+            return *pools[node];
+        }
+    }
+    return *pools[local];
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void* NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocate()
+{
+    return pools[localNode()] -> allocate();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void* NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocateOnNode(size_t node)
+{
+    return pools[poolIndex(node)] -> allocate();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::deallocate(void* ptr)
+{
+    ownerOf(ptr).deallocate(ptr);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::allocateBatch(void** out, size_t count)
+{
+    pools[localNode()] -> allocateBatch(out, count);
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+void NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::deallocateBatch(void** ptrs, size_t count)
+{
+    if (pools.size() == 1)
+    {
+        pools[0] -> deallocateBatch(ptrs, count);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        deallocate(ptrs[i]);
+    }
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::trim(size_t keepFreeChunks)
+{
+    size_t releasedCnt = 0;
+    for (auto& pool : pools)
+    {
+        releasedCnt += pool -> trim(keepFreeChunks);
+    }
+    return releasedCnt;
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+size_t NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::nodesCount() const
+{
+    return pools.size();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+AllocatorStats NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::stats(size_t node)
+{
+    return pools[poolIndex(node)] -> stats();
+}
+
+template <size_t chunkSize, size_t chunkAlign, bool cacheLineAligned>
+AllocatorStats NumaFixedAllocator<chunkSize, chunkAlign, cacheLineAligned>::stats()
+{
+    AllocatorStats result;
+    for (auto& pool : pools)
+    {
+        AllocatorStats poolStats = pool -> stats();
+        result.allocations += poolStats.allocations;
+        result.deallocations += poolStats.deallocations;
+        result.liveChunks += poolStats.liveChunks;
+        result.peakChunks += poolStats.peakChunks;
+        result.blocks += poolStats.blocks;
+        result.paddingBytes += poolStats.paddingBytes;
+    }
+    return result;
+}
+
+//////////////////////////////////////////////////////////
+class FastAllocatorPools
+{
+public:
+    template<typename Pool, typename... Args>
+    Pool* get(Args&&... args);
+
+private:
+    std::vector<std::pair<const std::type_info*, std::shared_ptr<void>>> pools;
+};
+
+template<typename Pool, typename... Args>
+Pool* FastAllocatorPools::get(Args&&... args)
+{
+    for (const auto& entry : pools)
+    {
+        if (*entry.first == typeid(Pool))
+        {
+            return static_cast<Pool*>(entry.second.get());
+        }
+    }
+    pools.emplace_back(&typeid(Pool), std::make_shared<Pool>(std::forward<Args>(args)...));
+    return static_cast<Pool*>(pools.back().second.get());
+}
+
+template<typename T, bool cacheLineAligned = false>
 struct FastAllocator
 {
 public:
@@ -97,83 +970,353 @@ public:
     template <typename U>
     struct rebind
     {
-        typedef FastAllocator<U> other;
+        typedef FastAllocator<U, cacheLineAligned> other;
     };
 
-    FastAllocator() = default;
-    FastAllocator(const FastAllocator&) {}
+    FastAllocator() : pools(std::make_shared<FastAllocatorPools>()), pool(pools -> get<Pool>()) {}
+    FastAllocator(const FastAllocator&) = default;
     template<typename U>
-    FastAllocator(const FastAllocator<U>&) {}
+    FastAllocator(const FastAllocator<U, cacheLineAligned>& another) : pools(another.pools), pool(pools -> get<Pool>()) {}
     ~FastAllocator() = default;
 
     T* allocate(size_t n);
     void deallocate(T *ptr, size_t n);
+    void allocateBatch(T** out, size_t count);
+    void deallocateBatch(T** ptrs, size_t count);
     template<typename... Args>
-    void construct(T *ptr, const Args &... args);
+    void construct(T *ptr, Args&&... args);
     void destroy(T *ptr);
 
-    bool operator==(const FastAllocator& another);
-    bool operator!=(const FastAllocator& another);
-    FastAllocator<T>& operator=(const FastAllocator<T>&);
+    bool operator==(const FastAllocator& another) const;
+    bool operator!=(const FastAllocator& another) const;
+    FastAllocator& operator=(const FastAllocator&) = default;
+    AllocatorStats stats() const;
+
+    template<typename U, bool>
+    friend struct FastAllocator;
 
 private:
-    FixedAllocator <sizeof(T)> fixAlloc;
+    using Pool = FixedAllocator<sizeof(T), alignof(T), cacheLineAligned>;
+    std::shared_ptr<FastAllocatorPools> pools;
+    Pool* pool;
+#ifdef FASTALLOCATOR_STATS
+    size_t fallbacksCnt = 0;
+#endif
 };
 
+template<typename T, bool cacheLineAligned>
+T* FastAllocator<T, cacheLineAligned>::allocate(size_t n)
+{
+    if (n == 1)
+    {
+        return reinterpret_cast<T*>(pool -> allocate());
+    }
+    FASTALLOCATOR_STAT(fallbacksCnt++);
+    return reinterpret_cast<T*>(operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+}
+
+template<typename T, bool cacheLineAligned>
+void FastAllocator<T, cacheLineAligned>::deallocate(T *ptr, size_t n)
+{
+    if (n == 1)
+    {
+        pool -> deallocate(ptr);
+    }
+    else
+    {
+        operator delete(ptr, std::align_val_t(alignof(T)));
+    }
+}
+
+template<typename T, bool cacheLineAligned>
+void FastAllocator<T, cacheLineAligned>::allocateBatch(T** out, size_t count)
+{
+    pool -> allocateBatch(reinterpret_cast<void**>(out), count);
+}
+
+template<typename T, bool cacheLineAligned>
+void FastAllocator<T, cacheLineAligned>::deallocateBatch(T** ptrs, size_t count)
+{
+    pool -> deallocateBatch(reinterpret_cast<void**>(ptrs), count);
+}
+
+template<typename T, bool cacheLineAligned>
+template<typename... Args>
+void FastAllocator<T, cacheLineAligned>::construct(T *ptr, Args&&... args)
+{
+    new(ptr) T(std::forward<Args>(args)...);
+}
+
+template<typename T, bool cacheLineAligned>
+void FastAllocator<T, cacheLineAligned>::destroy(T *ptr)
+{
+    ptr->~T();
+}
+
+template<typename T, bool cacheLineAligned>
+AllocatorStats FastAllocator<T, cacheLineAligned>::stats() const
+{
+    AllocatorStats result = pool -> stats();
+#ifdef FASTALLOCATOR_STATS
+    result.fallbacks = fallbacksCnt;
+#endif
+    return result;
+}
+
+template<typename T, bool cacheLineAligned>
+bool FastAllocator<T, cacheLineAligned>::operator==(const FastAllocator& another) const
+{
+    return (pool == another.pool);
+}
+
+template<typename T, bool cacheLineAligned>
+bool FastAllocator<T, cacheLineAligned>::operator!=(const FastAllocator& another) const
+{
+    return !(*this == another);
+}
+
+//////////////////////////////////////////////////////////
 template<typename T>
-T* FastAllocator<T>::allocate(size_t n)
+struct NumaAllocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef NumaAllocator<U> other;
+    };
+
+    explicit NumaAllocator(int boundNode = -1) : boundNode(boundNode), pools(std::make_shared<FastAllocatorPools>()), pool(pools -> get<Pool>(boundNode)) {}
+    NumaAllocator(const NumaAllocator&) = default;
+    template<typename U>
+    NumaAllocator(const NumaAllocator<U>& another) : boundNode(another.boundNode), pools(another.pools), pool(pools -> get<Pool>(boundNode)) {}
+    NumaAllocator& operator=(const NumaAllocator&) = default;
+
+    T* allocate(size_t n);
+    void deallocate(T *ptr, size_t n);
+    void allocateBatch(T** out, size_t count);
+    void deallocateBatch(T** ptrs, size_t count);
+
+    int node() const;
+    bool operator==(const NumaAllocator& another) const;
+    bool operator!=(const NumaAllocator& another) const;
+    AllocatorStats stats() const;
+
+    template<typename U>
+    friend struct NumaAllocator;
+
+private:
+    using Pool = NumaFixedAllocator<sizeof(T), alignof(T)>;
+    int boundNode;
+    std::shared_ptr<FastAllocatorPools> pools;
+    Pool* pool;
+};
+
+template<typename T>
+T* NumaAllocator<T>::allocate(size_t n)
 {
     if (n == 1)
     {
-        return reinterpret_cast<T*>(fixAlloc.allocate());
+        return reinterpret_cast<T*>(pool -> allocate());
     }
-    return reinterpret_cast<T*>(operator new(n * sizeof(T)));
+    return reinterpret_cast<T*>(operator new(n * sizeof(T), std::align_val_t(alignof(T))));
 }
 
 template<typename T>
-void FastAllocator<T>::deallocate(T *ptr, size_t n)
+void NumaAllocator<T>::deallocate(T *ptr, size_t n)
 {
     if (n == 1)
     {
-        fixAlloc.deallocate(ptr);
+        pool -> deallocate(ptr);
     }
     else
     {
-        operator delete(ptr);
+        operator delete(ptr, std::align_val_t(alignof(T)));
     }
 }
 
 template<typename T>
-template<typename... Args>
-void FastAllocator<T>::construct(T *ptr, const Args &... args)
+void NumaAllocator<T>::allocateBatch(T** out, size_t count)
 {
-    new(ptr) T(args...);
+    pool -> allocateBatch(reinterpret_cast<void**>(out), count);
 }
 
 template<typename T>
-void FastAllocator<T>::destroy(T *ptr)
+void NumaAllocator<T>::deallocateBatch(T** ptrs, size_t count)
 {
-    ptr->~T();
+    pool -> deallocateBatch(reinterpret_cast<void**>(ptrs), count);
 }
 
 template<typename T>
-bool FastAllocator<T>::operator==(const FastAllocator& another)
+int NumaAllocator<T>::node() const
 {
-    return (fixAlloc == another.fixAlloc);
+    return boundNode;
 }
 
 template<typename T>
-bool FastAllocator<T>::operator!=(const FastAllocator& another)
+AllocatorStats NumaAllocator<T>::stats() const
 {
-    return !(*this == another);
+    return pool -> stats();
 }
 
 template<typename T>
-FastAllocator<T>& FastAllocator<T>::operator=(const FastAllocator<T>&)
+bool NumaAllocator<T>::operator==(const NumaAllocator& another) const
 {
-    return *this;
+    return (pool == another.pool);
+}
+
+template<typename T>
+bool NumaAllocator<T>::operator!=(const NumaAllocator& another) const
+{
+    return !(*this == another);
+}
+
+//////////////////////////////////////////////////////////
+const size_t poolResourceMinChunk = 8;
+const size_t poolResourceMaxChunk = 512;
+
+class FixedPoolResource : public std::pmr::memory_resource
+{
+public:
+    explicit FixedPoolResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    FixedPoolResource(const FixedPoolResource&) = delete;
+    FixedPoolResource& operator=(const FixedPoolResource&) = delete;
+
+    std::pmr::memory_resource* upstream_resource() const;
+    size_t trim();
+    AllocatorStats stats() const;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& another) const noexcept override;
+
+private:
+    static constexpr size_t poolAlign = alignof(std::max_align_t);
+
+    std::tuple<FixedAllocator<8, 8>, FixedAllocator<16, poolAlign>, FixedAllocator<32, poolAlign>,
+               FixedAllocator<64, poolAlign>, FixedAllocator<128, poolAlign>, FixedAllocator<256, poolAlign>,
+               FixedAllocator<512, poolAlign>> pools;
+    std::pmr::memory_resource* upstream;
+
+    static size_t poolIndex(size_t bytes);
+    template<size_t I = 0>
+    void* allocateFrom(size_t index);
+    template<size_t I = 0>
+    void deallocateTo(size_t index, void* ptr);
+};
+
+inline FixedPoolResource::FixedPoolResource(std::pmr::memory_resource* upstream) : upstream(upstream)
+{
+    std::apply([upstream](auto&... pool)
+    {
+        (pool.setUpstream(upstream), ...);
+    }, pools);
+}
+
+inline std::pmr::memory_resource* FixedPoolResource::upstream_resource() const
+{
+    return upstream;
+}
+
+inline size_t FixedPoolResource::poolIndex(size_t bytes)
+{
+    size_t index = 0;
+    for (size_t chunk = poolResourceMinChunk; chunk < bytes; chunk *= 2)
+    {
+        ++index;
+    }
+    return index;
+}
+
+template<size_t I>
+void* FixedPoolResource::allocateFrom(size_t index)
+{
+    if constexpr (I < std::tuple_size<decltype(pools)>::value)
+    {
+        return index == I ? std::get<I>(pools).allocate() : allocateFrom<I + 1>(index);
+    }
+    else
+    {
+        return nullptr;
+    }
 }
 
+template<size_t I>
+void FixedPoolResource::deallocateTo(size_t index, void* ptr)
+{
+    if constexpr (I < std::tuple_size<decltype(pools)>::value)
+    {
+        if (index == I)
+        {
+            std::get<I>(pools).deallocate(ptr);
+        }
+        else
+        {
+            deallocateTo<I + 1>(index, ptr);
+        }
+    }
+}
+
+inline void* FixedPoolResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (bytes > poolResourceMaxChunk || alignment > poolAlign)
+    {
+        return upstream -> allocate(bytes, alignment);
+    }
+    return allocateFrom(poolIndex(std::max(bytes, alignment)));
+}
+
+inline void FixedPoolResource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+{
+    if (bytes > poolResourceMaxChunk || alignment > poolAlign)
+    {
+        upstream -> deallocate(ptr, bytes, alignment);
+        return;
+    }
+    deallocateTo(poolIndex(std::max(bytes, alignment)), ptr);
+}
+
+inline bool FixedPoolResource::do_is_equal(const std::pmr::memory_resource& another) const noexcept
+{
+    return this == &another;
+}
+
+inline size_t FixedPoolResource::trim()
+{
+    return std::apply([](auto&... pool)
+    {
+        return (pool.trim() + ...);
+    }, pools);
+}
+
+inline AllocatorStats FixedPoolResource::stats() const
+{
+    AllocatorStats result;
+    std::apply([&result](const auto&... pool)
+    {
+        ([&result](const AllocatorStats& poolStats)
+        {
+            result.allocations += poolStats.allocations;
+            result.deallocations += poolStats.deallocations;
+            result.liveChunks += poolStats.liveChunks;
+            result.peakChunks += poolStats.peakChunks;
+            result.blocks += poolStats.blocks;
+            result.paddingBytes += poolStats.paddingBytes;
+        }(pool.stats()), ...);
+    }, pools);
+    return result;
+}
+
+template<typename Alloc, typename = void>
+struct hasBatchAllocation : std::false_type {};
+
+template<typename Alloc>
+struct hasBatchAllocation<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocateBatch(nullptr, 0))>> : std::true_type {};
+
 ///////////////////////////////////////////////////////////////////
 template<typename T, typename Allocator =  FastAllocator<T>>
 class List
@@ -181,9 +1324,8 @@ class List
 private:
     struct Node
     {
-        explicit Node(const T& val): value(val) {}
-
-        Node () = default;
+        template<typename... Args>
+        explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
 
         T value;
         Node* prev = nullptr;
@@ -198,14 +1340,28 @@ private:
     AllocNode alloc;
 
     using AllocTraits = std::allocator_traits<AllocNode>;
+    static constexpr size_t nodeBatchSz = 64;
 
     void createFakeTail();
+    void linkBefore(Node* pos, Node* first, Node* last);
+    void unlink(Node* first, Node* last);
+    void transfer(Node* pos, List& another, Node* first, Node* last, size_t count);
+    void allocateNodes(Node** nodes, size_t count);
+    void deallocateNodes(Node** nodes, size_t count);
+    template<typename Constructor>
+    void appendNodes(size_t count, Constructor construct);
+    void destroyNodes(Node* first);
+    template<typename Compare>
+    static Node* mergeSort(Node* first, size_t count, Compare& comp);
+    template<typename Func>
+    static void walkPrefetched(Node* node, Node* end, Func& func, size_t distance);
 
 public:
     explicit List(const Allocator& alloc = Allocator());
     explicit List(size_t count, const Allocator& alloc = Allocator());
     explicit List(size_t count, const T& value, const Allocator& alloc = Allocator());
     List (const List& another);
+    List (List&& another);
     ~List();
 
     template <bool isConst>
@@ -247,6 +1403,30 @@ public:
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+    class node_type
+    {
+    public:
+        friend List;
+
+        node_type() = default;
+        node_type(node_type&& another) noexcept;
+        node_type& operator=(node_type&& another) noexcept;
+        ~node_type();
+
+        bool empty() const;
+        explicit operator bool() const;
+        T& value() const;
+        AllocNode get_allocator() const;
+
+    private:
+        Node* node = nullptr;
+        std::optional<AllocNode> alloc;
+
+        node_type(Node* p, const AllocNode& allocator);
+        Node* release();
+        void destroyNode();
+    };
+
     iterator begin();
     iterator end();
     const_iterator begin() const;
@@ -261,14 +1441,46 @@ public:
     const_reverse_iterator crend() const;
 
     List& operator=(const List& another);
+    List& operator=(List&& another);
     AllocNode get_allocator() const;
     void insert(const_iterator it, const T& val);
+    void insert(const_iterator it, T&& val);
+    template<typename... Args>
+    iterator emplace(const_iterator it, Args&&... args);
+    template<typename... Args>
+    T& emplace_back(Args&&... args);
+    template<typename... Args>
+    T& emplace_front(Args&&... args);
     void erase(const_iterator it);
     void push_back(const T &value);
+    void push_back(T&& value);
     void push_front(const T& value);
+    void push_front(T&& value);
     void pop_back();
     void pop_front();
     size_t size() const;
+
+    void splice(const_iterator pos, List& another);
+    void splice(const_iterator pos, List&& another);
+    void splice(const_iterator pos, List& another, const_iterator it);
+    void splice(const_iterator pos, List&& another, const_iterator it);
+    void splice(const_iterator pos, List& another, const_iterator first, const_iterator last);
+    void splice(const_iterator pos, List&& another, const_iterator first, const_iterator last);
+    void merge(List& another);
+    void merge(List&& another);
+    template<typename Compare>
+    void merge(List& another, Compare comp);
+    template<typename Compare>
+    void merge(List&& another, Compare comp);
+    void sort();
+    template<typename Compare>
+    void sort(Compare comp);
+    node_type extract(const_iterator it);
+    iterator insert(const_iterator it, node_type&& nodeHandle);
+    template<typename Func>
+    void for_each_prefetched(Func func, size_t distance = defaultPrefetchDistance);
+    template<typename Func>
+    void for_each_prefetched(Func func, size_t distance = defaultPrefetchDistance) const;
 };
 
 //////////////////////////////////////////
@@ -282,99 +1494,248 @@ void List<T, Allocator>::createFakeTail()
 }
 
 template<typename T, typename Allocator>
-List<T, Allocator>::List(const Allocator& allocator) : sz(0), alloc(allocator)
+void List<T, Allocator>::linkBefore(Node* pos, Node* first, Node* last)
+{
+    first -> prev = pos -> prev;
+    last -> next = pos;
+    if (pos -> prev != nullptr)
+    {
+        pos -> prev -> next = first;
+    }
+    else
+    {
+        head = first;
+    }
+    pos -> prev = last;
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::unlink(Node* first, Node* last)
+{
+    last -> next -> prev = first -> prev;
+    if (first -> prev != nullptr)
+    {
+        first -> prev -> next = last -> next;
+    }
+    else
+    {
+        head = last -> next;
+    }
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(const Allocator& allocator) : sz(0), alloc(allocator)
+{
+    createFakeTail();
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::allocateNodes(Node** nodes, size_t count)
+{
+    if constexpr (hasBatchAllocation<AllocNode>::value)
+    {
+        alloc.allocateBatch(nodes, count);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            nodes[i] = AllocTraits::allocate(alloc, 1);
+        }
+    }
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::deallocateNodes(Node** nodes, size_t count)
+{
+    if constexpr (hasBatchAllocation<AllocNode>::value)
+    {
+        alloc.deallocateBatch(nodes, count);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            AllocTraits::deallocate(alloc, nodes[i], 1);
+        }
+    }
+}
+
+template<typename T, typename Allocator>
+template<typename Constructor>
+void List<T, Allocator>::appendNodes(size_t count, Constructor construct)
 {
-    createFakeTail();
+    Node* nodes[nodeBatchSz];
+    while (count > 0)
+    {
+        size_t batch = std::min(count, nodeBatchSz);
+        allocateNodes(nodes, batch);
+        size_t i = 0;
+        try
+        {
+            for (; i < batch; ++i)
+            {
+                construct(nodes[i]);
+                linkBefore(fakeTail, nodes[i], nodes[i]);
+                sz++;
+            }
+        }
+        catch (...)
+        {
+            deallocateNodes(nodes + i, batch - i);
+            throw;
+        }
+        count -= batch;
+    }
 }
 
 template<typename T, typename Allocator>
-List<T, Allocator>::List(size_t count, const Allocator& allocator) : List(allocator)
+void List<T, Allocator>::destroyNodes(Node* first)
 {
-    for (size_t i = 0; i < count; ++i)
+    if (first == fakeTail)
     {
-        Node *newNode = AllocTraits::allocate(alloc, 1);
-        AllocTraits::construct(alloc, newNode);
-
-        newNode->next = fakeTail;
-        newNode->prev = fakeTail->prev;
-        newNode->next->prev = newNode;
-
-        if (newNode->prev != nullptr)
-        {
-            newNode->prev->next = newNode;
-        }
-        else
+        return;
+    }
+    Node* last = fakeTail -> prev;
+    unlink(first, last);
+    Node* nodes[nodeBatchSz];
+    size_t batch = 0;
+    for (Node* node = first; node != fakeTail;)
+    {
+        Node* next = node -> next;
+        AllocTraits::destroy(alloc, node);
+        nodes[batch++] = node;
+        sz--;
+        if (batch == nodeBatchSz)
         {
-            head = newNode;
+            deallocateNodes(nodes, batch);
+            batch = 0;
         }
-        sz++;
+        node = next;
     }
+    deallocateNodes(nodes, batch);
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(size_t count, const Allocator& allocator) : List(allocator)
+{
+    appendNodes(count, [this](Node* node)
+    {
+        AllocTraits::construct(alloc, node);
+    });
 }
 
 template<typename T, typename Allocator>
 List<T, Allocator>::List(size_t count, const T& value, const Allocator& alloc) : List(alloc)
 {
-    for (size_t i = 0; i < count; ++i)
+    appendNodes(count, [this, &value](Node* node)
     {
-        push_back(value);
-    }
+        AllocTraits::construct(this -> alloc, node, value);
+    });
 }
 
 template<typename T, typename Allocator>
 List<T, Allocator>::List(const List& another) : List(std::allocator_traits<Allocator>::select_on_container_copy_construction(another.alloc))
 {
-    Node *node = another.head;
-    for (size_t i = 0; i < another.sz; ++i)
+    const Node* source = another.head;
+    appendNodes(another.sz, [this, &source](Node* node)
     {
-        push_back(node->value);
-        node = node->next;
-    }
+        AllocTraits::construct(alloc, node, source -> value);
+        source = source -> next;
+    });
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(List&& another) : head(another.head), fakeTail(another.fakeTail), sz(another.sz), alloc(std::move(another.alloc))
+{
+    another.sz = 0;
+    another.createFakeTail();
 }
 
 template<typename T, typename Allocator>
 typename List<T, Allocator>::List& List<T, Allocator>::operator=(const List& another)
 {
-    size_t cnt = sz;
-    for (size_t i = 0; i < cnt; ++i)
+    if (this == &another)
     {
-        pop_back();
+        return *this;
     }
-
-    if (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
     {
+        destroyNodes(head);
+        AllocTraits::deallocate(alloc, fakeTail, 1);
         alloc = another.alloc;
+        createFakeTail();
     }
-    fakeTail -> next = nullptr;
-    fakeTail -> prev = nullptr;
-    head = fakeTail;
-    sz = 0;
-    Node* node = another.head;
-    for (size_t i = 0; i < another.sz; ++i)
+
+    Node* node = head;
+    const Node* source = another.head;
+    for (; node != fakeTail && source != another.fakeTail; node = node -> next, source = source -> next)
     {
-        push_back(node -> value);
-        node = node -> next;
+        node -> value = source -> value;
     }
+    destroyNodes(node);
+    appendNodes(another.sz - sz, [this, &source](Node* newNode)
+    {
+        AllocTraits::construct(alloc, newNode, source -> value);
+        source = source -> next;
+    });
     return *this;
 }
 
 template<typename T, typename Allocator>
-List<T, Allocator>::~List()
+typename List<T, Allocator>::List& List<T, Allocator>::operator=(List&& another)
 {
-    size_t cnt = sz;
-    for (size_t i = 0; i < cnt; ++i)
+    if (this == &another)
     {
-        iterator it = end();
-        it--;
-        erase(it);
+        return *this;
+    }
+    destroyNodes(head);
+
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value)
+    {
+        AllocTraits::deallocate(alloc, fakeTail, 1);
+        alloc = std::move(another.alloc);
+        head = another.head;
+        fakeTail = another.fakeTail;
+        sz = another.sz;
+        another.sz = 0;
+        another.createFakeTail();
+    }
+    else
+    {
+        for (T& value : another)
+        {
+            emplace_back(std::move(value));
+        }
     }
+    return *this;
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::~List()
+{
+    destroyNodes(head);
     AllocTraits::deallocate(alloc, fakeTail, 1);
 }
 
 template<typename T, typename Allocator>
 void List<T, Allocator>::insert(const_iterator it, const T& val)
+{
+    emplace(it, val);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::insert(const_iterator it, T&& val)
+{
+    emplace(it, std::move(val));
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+typename List<T, Allocator>::iterator List<T, Allocator>::emplace(const_iterator it, Args&&... args)
 {
     Node* newNode = AllocTraits::allocate(alloc, 1);
-    AllocTraits::construct(alloc, newNode, val);
+    AllocTraits::construct(alloc, newNode, std::forward<Args>(args)...);
 
     newNode -> next = it.getPointer();
     newNode -> prev = it.getPointer() -> prev;
@@ -389,6 +1750,21 @@ void List<T, Allocator>::insert(const_iterator it, const T& val)
         head = newNode;
     }
     sz++;
+    return iterator(newNode);
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+T& List<T, Allocator>::emplace_back(Args&&... args)
+{
+    return *emplace(cend(), std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+T& List<T, Allocator>::emplace_front(Args&&... args)
+{
+    return *emplace(cbegin(), std::forward<Args>(args)...);
 }
 
 template<typename T, typename Allocator>
@@ -416,12 +1792,24 @@ void List<T, Allocator>::push_back(const T &value)
     insert(cend(), value);
 }
 
+template<typename T, typename Allocator>
+void List<T, Allocator>::push_back(T&& value)
+{
+    insert(cend(), std::move(value));
+}
+
 template<typename T, typename Allocator>
 void List<T, Allocator>::push_front(const T& value)
 {
     insert(cbegin(), value);
 }
 
+template<typename T, typename Allocator>
+void List<T, Allocator>::push_front(T&& value)
+{
+    insert(cbegin(), std::move(value));
+}
+
 template<typename T, typename Allocator>
 void List<T, Allocator>::pop_back()
 {
@@ -520,6 +1908,343 @@ typename List<T, Allocator>::const_reverse_iterator List<T, Allocator>::crend()
     return std::make_reverse_iterator(begin());
 }
 
+template<typename T, typename Allocator>
+void List<T, Allocator>::transfer(Node* pos, List& another, Node* first, Node* last, size_t count)
+{
+    if (alloc == another.alloc)
+    {
+        another.unlink(first, last);
+        another.sz -= count;
+        linkBefore(pos, first, last);
+        sz += count;
+        return;
+    }
+    Node* stop = last -> next;
+    for (Node* node = first; node != stop;)
+    {
+        Node* next = node -> next;
+        emplace(const_iterator(pos), std::move(node -> value));
+        another.erase(const_iterator(node));
+        node = next;
+    }
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator pos, List& another)
+{
+    if (another.sz == 0 || this == &another)
+    {
+        return;
+    }
+    transfer(pos.getPointer(), another, another.head, another.fakeTail -> prev, another.sz);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator pos, List&& another)
+{
+    splice(pos, another);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator pos, List& another, const_iterator it)
+{
+    Node* node = it.getPointer();
+    if (node == pos.getPointer() || node -> next == pos.getPointer())
+    {
+        return;
+    }
+    transfer(pos.getPointer(), another, node, node, 1);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator pos, List&& another, const_iterator it)
+{
+    splice(pos, another, it);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator pos, List& another, const_iterator first, const_iterator last)
+{
+    if (first == last)
+    {
+        return;
+    }
+    size_t count = 0;
+    Node* lastNode = first.getPointer();
+    for (const_iterator it = first; it != last; ++it)
+    {
+        lastNode = it.getPointer();
+        ++count;
+    }
+    transfer(pos.getPointer(), another, first.getPointer(), lastNode, count);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::splice(const_iterator pos, List&& another, const_iterator first, const_iterator last)
+{
+    splice(pos, another, first, last);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::merge(List& another)
+{
+    merge(another, std::less<T>());
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::merge(List&& another)
+{
+    merge(another, std::less<T>());
+}
+
+template<typename T, typename Allocator>
+template<typename Compare>
+void List<T, Allocator>::merge(List& another, Compare comp)
+{
+    if (this == &another)
+    {
+        return;
+    }
+    const_iterator pos = cbegin();
+    while (another.sz != 0)
+    {
+        if (pos == cend())
+        {
+            splice(pos, another);
+            return;
+        }
+        Node* first = another.head;
+        if (!comp(first -> value, *pos))
+        {
+            ++pos;
+            continue;
+        }
+        Node* last = first;
+        size_t count = 1;
+        while (last -> next != another.fakeTail && comp(last -> next -> value, *pos))
+        {
+            last = last -> next;
+            ++count;
+        }
+        transfer(pos.getPointer(), another, first, last, count);
+    }
+}
+
+template<typename T, typename Allocator>
+template<typename Compare>
+void List<T, Allocator>::merge(List&& another, Compare comp)
+{
+    merge(another, comp);
+}
+
+template<typename T, typename Allocator>
+template<typename Compare>
+typename List<T, Allocator>::Node* List<T, Allocator>::mergeSort(Node* first, size_t count, Compare& comp)
+{
+    if (count < 2)
+    {
+        first -> next = nullptr;
+        return first;
+    }
+    Node* middle = first;
+    for (size_t i = 0; i < count / 2; ++i)
+    {
+        middle = middle -> next;
+    }
+    Node* right = mergeSort(middle, count - count / 2, comp);
+    Node* left = mergeSort(first, count / 2, comp);
+
+    Node* result = nullptr;
+    Node** tail = &result;
+    while (left != nullptr && right != nullptr)
+    {
+        if (comp(right -> value, left -> value))
+        {
+            *tail = right;
+            right = right -> next;
+        }
+        else
+        {
+            *tail = left;
+            left = left -> next;
+        }
+        tail = &((*tail) -> next);
+    }
+    *tail = (left != nullptr ? left : right);
+    return result;
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::sort()
+{
+    sort(std::less<T>());
+}
+
+template<typename T, typename Allocator>
+template<typename Compare>
+void List<T, Allocator>::sort(Compare comp)
+{
+    if (sz < 2)
+    {
+        return;
+    }
+    head = mergeSort(head, sz, comp);
+    head -> prev = nullptr;
+    Node* node = head;
+    while (node -> next != nullptr)
+    {
+        node -> next -> prev = node;
+        node = node -> next;
+    }
+    node -> next = fakeTail;
+    fakeTail -> prev = node;
+}
+
+template<typename T, typename Allocator>
+template<typename Func>
+void List<T, Allocator>::walkPrefetched(Node* node, Node* end, Func& func, size_t distance)
+{
+    while (node != end)
+    {
+        Node* next = node -> next;
+        uintptr_t stride = reinterpret_cast<uintptr_t>(next) - reinterpret_cast<uintptr_t>(node);
+        prefetchRead(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(next) + stride * distance));
+        func(node -> value);
+        node = next;
+    }
+}
+
+template<typename T, typename Allocator>
+template<typename Func>
+void List<T, Allocator>::for_each_prefetched(Func func, size_t distance)
+{
+    walkPrefetched(head, fakeTail, func, distance);
+}
+
+template<typename T, typename Allocator>
+template<typename Func>
+void List<T, Allocator>::for_each_prefetched(Func func, size_t distance) const
+{
+    auto constFunc = [&func](const T& value)
+    {
+        func(value);
+    };
+    walkPrefetched(head, fakeTail, constFunc, distance);
+}
+
+template<typename T, typename Allocator>
+typename List<T, Allocator>::node_type List<T, Allocator>::extract(const_iterator it)
+{
+    Node* node = it.getPointer();
+    unlink(node, node);
+    sz--;
+    node -> prev = nullptr;
+    node -> next = nullptr;
+    return node_type(node, alloc);
+}
+
+template<typename T, typename Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::insert(const_iterator it, node_type&& nodeHandle)
+{
+    if (nodeHandle.empty())
+    {
+        return iterator(it.getPointer());
+    }
+    if (!(*nodeHandle.alloc == alloc))
+    {
+        iterator result = emplace(it, std::move(nodeHandle.value()));
+        nodeHandle = node_type();
+        return result;
+    }
+    Node* node = nodeHandle.release();
+    linkBefore(it.getPointer(), node, node);
+    sz++;
+    return iterator(node);
+}
+
+///////////////////////////////////////////////
+template<typename T, typename Allocator>
+List<T, Allocator>::node_type::node_type(Node* p, const AllocNode& allocator) : node(p), alloc(allocator) {}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::node_type::node_type(node_type&& another) noexcept : node(another.node)
+{
+    if (another.alloc)
+    {
+        alloc.emplace(*another.alloc);
+    }
+    another.node = nullptr;
+    another.alloc.reset();
+}
+
+template<typename T, typename Allocator>
+typename List<T, Allocator>::node_type& List<T, Allocator>::node_type::operator=(node_type&& another) noexcept
+{
+    if (this != &another)
+    {
+        destroyNode();
+        node = another.node;
+        alloc.reset();
+        if (another.alloc)
+        {
+            alloc.emplace(*another.alloc);
+        }
+        another.node = nullptr;
+        another.alloc.reset();
+    }
+    return *this;
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::node_type::~node_type()
+{
+    destroyNode();
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::node_type::destroyNode()
+{
+    if (node != nullptr)
+    {
+        AllocTraits::destroy(*alloc, node);
+        AllocTraits::deallocate(*alloc, node, 1);
+        node = nullptr;
+    }
+}
+
+template<typename T, typename Allocator>
+bool List<T, Allocator>::node_type::empty() const
+{
+    return node == nullptr;
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::node_type::operator bool() const
+{
+    return node != nullptr;
+}
+
+template<typename T, typename Allocator>
+T& List<T, Allocator>::node_type::value() const
+{
+    return node -> value;
+}
+
+template<typename T, typename Allocator>
+typename List<T, Allocator>::AllocNode List<T, Allocator>::node_type::get_allocator() const
+{
+    return *alloc;
+}
+
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Node* List<T, Allocator>::node_type::release()
+{
+    Node* result = node;
+    node = nullptr;
+    alloc.reset();
+    return result;
+}
+
 ///////////////////////////////////////////////
 template<typename T, typename Allocator>
 template<bool isConst>
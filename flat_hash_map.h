@@ -0,0 +1,842 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <tuple>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <iterator>
+#include <cstring>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+const float defaultFlatMaxLoadFactor = 0.875;
+const float flatLoadFactorLimit = 0.95;
+const float flatLoadFactorMin = 0.1;
+const size_t flatMinCapacity = 15;
+
+const int8_t ctrlEmpty = -128;
+const int8_t ctrlDeleted = -2;
+const int8_t ctrlSentinel = -1;
+
+inline int countTrailingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    for (; (value & 1) == 0; value >>= 1)
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline int countLeadingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    for (uint64_t bit = uint64_t(1) << 63; (value & bit) == 0; bit >>= 1)
+    {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+template<typename T, int width, int shift>
+class BitMask
+{
+public:
+    explicit BitMask(T mask) : mask(mask) {}
+
+    explicit operator bool() const;
+    int lowestBitSet() const;
+    int trailingZeros() const;
+    int leadingZeros() const;
+    void clearLowest();
+
+private:
+    T mask;
+};
+
+template<typename T, int width, int shift>
+BitMask<T, width, shift>::operator bool() const
+{
+    return mask != 0;
+}
+
+template<typename T, int width, int shift>
+int BitMask<T, width, shift>::lowestBitSet() const
+{
+    return countTrailingZeros(mask) >> shift;
+}
+
+template<typename T, int width, int shift>
+int BitMask<T, width, shift>::trailingZeros() const
+{
+    return mask == 0 ? width : lowestBitSet();
+}
+
+template<typename T, int width, int shift>
+int BitMask<T, width, shift>::leadingZeros() const
+{
+    if (mask == 0)
+    {
+        return width;
+    }
+    return (countLeadingZeros(mask) - (64 - (width << shift))) >> shift;
+}
+
+template<typename T, int width, int shift>
+void BitMask<T, width, shift>::clearLowest()
+{
+    mask &= mask - 1;
+}
+
+#ifdef FLAT_HASH_MAP_SSE2
+class CtrlGroup
+{
+public:
+    static constexpr size_t width = 16;
+    using Mask = BitMask<uint64_t, width, 0>;
+
+    explicit CtrlGroup(const int8_t* ctrl) : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    Mask match(int8_t tag) const
+    {
+        return Mask(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), bytes))));
+    }
+
+    Mask matchEmpty() const
+    {
+        return match(ctrlEmpty);
+    }
+
+    Mask matchFree() const
+    {
+        return Mask(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrlSentinel), bytes))));
+    }
+
+private:
+    __m128i bytes;
+};
+#else
+class CtrlGroup
+{
+public:
+    static constexpr size_t width = 8;
+    using Mask = BitMask<uint64_t, width, 3>;
+
+    explicit CtrlGroup(const int8_t* ctrl)
+    {
+        std::memcpy(&bytes, ctrl, sizeof(bytes));
+    }
+
+    Mask match(int8_t tag) const
+    {
+        uint64_t diff = bytes ^ (lsbs * static_cast<uint8_t>(tag));
+        return Mask((diff - lsbs) & ~diff & msbs);
+    }
+
+    Mask matchEmpty() const
+    {
+        return Mask(bytes & ~(bytes << 6) & msbs);
+    }
+
+    Mask matchFree() const
+    {
+        return Mask(bytes & ~(bytes << 7) & msbs);
+    }
+
+private:
+    static constexpr uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr uint64_t msbs = 0x8080808080808080ull;
+    uint64_t bytes;
+};
+#endif
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Value>>>
+class FlatHashMap
+{
+public:
+    using NodeType = std::pair<const Key, Value>;
+
+    FlatHashMap();
+    FlatHashMap(const FlatHashMap& another);
+    FlatHashMap(FlatHashMap&& another) noexcept;
+    explicit FlatHashMap(size_t bucketsCount);
+    explicit FlatHashMap(const Alloc& alloc, size_t bucketsCount = 0);
+    ~FlatHashMap();
+    FlatHashMap& operator=(const FlatHashMap& another);
+    FlatHashMap& operator=(FlatHashMap&& another) noexcept;
+
+    template <bool isConst>
+    class MapIterator
+    {
+    public:
+        friend FlatHashMap;
+
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename std::conditional<isConst, const NodeType, NodeType>::type;
+        using pointer = typename std::conditional<isConst, const NodeType*, NodeType*>::type;
+        using reference = typename std::conditional<isConst, const NodeType&, NodeType&>::type;
+        using iterator_category = std::forward_iterator_tag;
+
+        MapIterator() = default;
+        template<bool isC = false>
+        MapIterator(const MapIterator<false>& another) : ctrl(another.ctrl), slot(another.slot) {}
+        MapIterator(const MapIterator& another) = default;
+        ~MapIterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        MapIterator& operator++();
+        MapIterator operator++(int);
+        MapIterator& operator=(const MapIterator& another) = default;
+        bool operator==(const MapIterator& another) const;
+        bool operator!=(const MapIterator& another) const;
+
+    private:
+        const int8_t* ctrl = nullptr;
+        NodeType* slot = nullptr;
+
+        MapIterator(const int8_t* ctrl, NodeType* slot);
+        void skipFree();
+    };
+    using Iterator = MapIterator<false>;
+    using ConstIterator = MapIterator<true>;
+
+    Iterator begin();
+    Iterator end();
+    ConstIterator begin() const;
+    ConstIterator end() const;
+    ConstIterator cbegin() const;
+    ConstIterator cend() const;
+
+    Iterator find(const Key& key);
+    ConstIterator find(const Key& key) const;
+    Value& operator[](const Key& key);
+    Value& at(const Key& key);
+    const Value& at(const Key& key) const;
+
+    void rehash(size_t count);
+    void reserve(size_t count);
+    float load_factor() const;
+    float max_load_factor() const;
+    void max_load_factor(float newLoadFactor);
+    size_t max_size() const;
+    size_t size() const;
+    size_t bucket_count() const;
+    void clear();
+
+    std::pair<Iterator, bool> insert(NodeType&& node);
+    template<typename Pair>
+    std::pair<Iterator, bool> insert(Pair&& pair);
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last);
+    template<typename... Args>
+    std::pair<Iterator, bool> emplace(Args&&... args);
+    Iterator erase(Iterator pos);
+    Iterator erase(Iterator first, Iterator last);
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using CtrlAlloc = typename AllocTraits::template rebind_alloc<int8_t>;
+    using CtrlAllocTraits = std::allocator_traits<CtrlAlloc>;
+
+    int8_t* ctrl;
+    NodeType* slots = nullptr;
+    size_t slotsCnt = 0;
+    size_t sz = 0;
+    size_t deletedCnt = 0;
+    float maxLoadFactor = defaultFlatMaxLoadFactor;
+    Hash hashFunction;
+    Equal equalFunction;
+    Alloc alloc;
+    CtrlAlloc ctrlAlloc;
+
+    static int8_t* emptyCtrl();
+    static size_t mixHash(size_t hash);
+    static int8_t tagOf(size_t hash);
+
+    void Swap(FlatHashMap& another) noexcept;
+    void allocateTable(size_t capacity);
+    void destroyTable();
+    size_t findIndex(const Key& key, size_t hash) const;
+    size_t findFreeIndex(size_t hash) const;
+    void setCtrl(size_t pos, int8_t value);
+    template<typename... Args>
+    size_t constructAt(size_t hash, Args&&... args);
+    size_t growthLimit() const;
+};
+
+///////////////////////////////////////////////////////
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+int8_t* FlatHashMap<Key, Value, Hash, Equal, Alloc>::emptyCtrl()
+{
+    static int8_t sentinel[1] = {ctrlSentinel};
+    return sentinel;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::mixHash(size_t hash)
+{
+    uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(mixed ^ (mixed >> 32));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+int8_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::tagOf(size_t hash)
+{
+    return static_cast<int8_t>(hash & 0x7F);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::FlatHashMap() :
+        ctrl(emptyCtrl()) {}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::FlatHashMap(size_t bucketsCount) :
+        FlatHashMap()
+{
+    rehash(bucketsCount);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::FlatHashMap(const Alloc& alloc, size_t bucketsCount) :
+        ctrl(emptyCtrl()),
+        alloc(alloc),
+        ctrlAlloc(alloc)
+{
+    rehash(bucketsCount);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::FlatHashMap(const FlatHashMap& another) :
+        ctrl(emptyCtrl()),
+        maxLoadFactor(another.maxLoadFactor),
+        hashFunction(another.hashFunction),
+        equalFunction(another.equalFunction),
+        alloc(AllocTraits::select_on_container_copy_construction(another.alloc)),
+        ctrlAlloc(alloc)
+{
+    if (another.slotsCnt == 0)
+    {
+        return;
+    }
+    allocateTable(another.slotsCnt);
+    for (size_t i = 0; i < slotsCnt; ++i)
+    {
+        if (another.ctrl[i] >= 0)
+        {
+            AllocTraits::construct(alloc, slots + i, another.slots[i]);
+            ++sz;
+        }
+        setCtrl(i, another.ctrl[i]);
+    }
+    deletedCnt = another.deletedCnt;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::FlatHashMap(FlatHashMap&& another) noexcept :
+        ctrl(emptyCtrl()),
+        hashFunction(another.hashFunction),
+        equalFunction(another.equalFunction),
+        alloc(another.alloc),
+        ctrlAlloc(alloc)
+{
+    Swap(another);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::~FlatHashMap()
+{
+    destroyTable();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::Swap(FlatHashMap& another) noexcept
+{
+    std::swap(ctrl, another.ctrl);
+    std::swap(slots, another.slots);
+    std::swap(slotsCnt, another.slotsCnt);
+    std::swap(sz, another.sz);
+    std::swap(deletedCnt, another.deletedCnt);
+    std::swap(maxLoadFactor, another.maxLoadFactor);
+    std::swap(hashFunction, another.hashFunction);
+    std::swap(equalFunction, another.equalFunction);
+    std::swap(alloc, another.alloc);
+    std::swap(ctrlAlloc, another.ctrlAlloc);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>& FlatHashMap<Key, Value, Hash, Equal, Alloc>::operator=(const FlatHashMap& another)
+{
+    FlatHashMap copy = another;
+    Swap(copy);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>& FlatHashMap<Key, Value, Hash, Equal, Alloc>::operator=(FlatHashMap&& another) noexcept
+{
+    FlatHashMap copy = std::move(another);
+    Swap(copy);
+    return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::allocateTable(size_t capacity)
+{
+    ctrl = CtrlAllocTraits::allocate(ctrlAlloc, capacity + CtrlGroup::width);
+    try
+    {
+        slots = AllocTraits::allocate(alloc, capacity);
+    }
+    catch (...)
+    {
+        CtrlAllocTraits::deallocate(ctrlAlloc, ctrl, capacity + CtrlGroup::width);
+        ctrl = emptyCtrl();
+        throw;
+    }
+    std::fill(ctrl, ctrl + capacity + CtrlGroup::width, ctrlEmpty);
+    ctrl[capacity] = ctrlSentinel;
+    slotsCnt = capacity;
+    sz = 0;
+    deletedCnt = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::destroyTable()
+{
+    if (slotsCnt == 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < slotsCnt; ++i)
+    {
+        if (ctrl[i] >= 0)
+        {
+            AllocTraits::destroy(alloc, slots + i);
+        }
+    }
+    AllocTraits::deallocate(alloc, slots, slotsCnt);
+    CtrlAllocTraits::deallocate(ctrlAlloc, ctrl, slotsCnt + CtrlGroup::width);
+    ctrl = emptyCtrl();
+    slots = nullptr;
+    slotsCnt = 0;
+    sz = 0;
+    deletedCnt = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::findIndex(const Key& key, size_t hash) const
+{
+    if (slotsCnt == 0)
+    {
+        return slotsCnt;
+    }
+    int8_t tag = tagOf(hash);
+    size_t pos = (hash >> 7) & slotsCnt;
+    for (size_t step = CtrlGroup::width;; step += CtrlGroup::width)
+    {
+        CtrlGroup group(ctrl + pos);
+        for (auto match = group.match(tag); match; match.clearLowest())
+        {
+            size_t index = (pos + match.lowestBitSet()) & slotsCnt;
+            if (equalFunction(slots[index].first, key))
+            {
+                return index;
+            }
+        }
+        if (group.matchEmpty())
+        {
+            return slotsCnt;
+        }
+        pos = (pos + step) & slotsCnt;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::findFreeIndex(size_t hash) const
+{
+    size_t pos = (hash >> 7) & slotsCnt;
+    for (size_t step = CtrlGroup::width;; step += CtrlGroup::width)
+    {
+        auto free = CtrlGroup(ctrl + pos).matchFree();
+        if (free)
+        {
+            return (pos + free.lowestBitSet()) & slotsCnt;
+        }
+        pos = (pos + step) & slotsCnt;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::setCtrl(size_t pos, int8_t value)
+{
+    ctrl[pos] = value;
+    if (pos < CtrlGroup::width - 1)
+    {
+        ctrl[slotsCnt + 1 + pos] = value;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::growthLimit() const
+{
+    return static_cast<size_t>(slotsCnt * maxLoadFactor);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename... Args>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::constructAt(size_t hash, Args&&... args)
+{
+    if (sz + deletedCnt + 1 > growthLimit())
+    {
+        rehash(sz + 1 > growthLimit() / 2 ? 2 * slotsCnt + 1 : slotsCnt);
+    }
+    size_t pos = findFreeIndex(hash);
+    AllocTraits::construct(alloc, slots + pos, std::forward<Args>(args)...);
+    if (ctrl[pos] == ctrlDeleted)
+    {
+        --deletedCnt;
+    }
+    setCtrl(pos, tagOf(hash));
+    ++sz;
+    return pos;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::rehash(size_t count)
+{
+    size_t required = std::max(count, static_cast<size_t>(std::ceil(sz / maxLoadFactor)) + 1);
+    size_t capacity = flatMinCapacity;
+    while (capacity < required)
+    {
+        capacity = 2 * capacity + 1;
+    }
+    if (count == 0 && sz == 0)
+    {
+        return;
+    }
+
+    FlatHashMap fresh(alloc);
+    fresh.maxLoadFactor = maxLoadFactor;
+    fresh.hashFunction = hashFunction;
+    fresh.equalFunction = equalFunction;
+    fresh.allocateTable(capacity);
+    for (size_t i = 0; i < slotsCnt; ++i)
+    {
+        if (ctrl[i] >= 0)
+        {
+            size_t pos = fresh.findFreeIndex(mixHash(hashFunction(slots[i].first)));
+            AllocTraits::construct(fresh.alloc, fresh.slots + pos, std::move_if_noexcept(slots[i]));
+            fresh.setCtrl(pos, ctrl[i]);
+            ++fresh.sz;
+        }
+    }
+    Swap(fresh);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::reserve(size_t count)
+{
+    if (count > growthLimit())
+    {
+        rehash(static_cast<size_t>(std::ceil(count / maxLoadFactor)));
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::clear()
+{
+    for (size_t i = 0; i < slotsCnt; ++i)
+    {
+        if (ctrl[i] >= 0)
+        {
+            AllocTraits::destroy(alloc, slots + i);
+        }
+        setCtrl(i, ctrlEmpty);
+    }
+    sz = 0;
+    deletedCnt = 0;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+float FlatHashMap<Key, Value, Hash, Equal, Alloc>::load_factor() const
+{
+    return slotsCnt == 0 ? 0 : static_cast<float>(sz) / slotsCnt;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+float FlatHashMap<Key, Value, Hash, Equal, Alloc>::max_load_factor() const
+{
+    return maxLoadFactor;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::max_load_factor(float newLoadFactor)
+{
+    maxLoadFactor = std::min(std::max(flatLoadFactorMin, newLoadFactor), flatLoadFactorLimit);
+    if (sz + deletedCnt > growthLimit())
+    {
+        rehash(static_cast<size_t>(std::ceil(sz / maxLoadFactor)));
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::max_size() const
+{
+    return growthLimit();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::size() const
+{
+    return sz;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t FlatHashMap<Key, Value, Hash, Equal, Alloc>::bucket_count() const
+{
+    return slotsCnt;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::begin()
+{
+    Iterator it(ctrl, slots);
+    it.skipFree();
+    return it;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::end()
+{
+    return Iterator(ctrl + slotsCnt, slots + slotsCnt);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::ConstIterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::begin() const
+{
+    ConstIterator it(ctrl, slots);
+    it.skipFree();
+    return it;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::ConstIterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::end() const
+{
+    return ConstIterator(ctrl + slotsCnt, slots + slotsCnt);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::ConstIterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::cbegin() const
+{
+    return begin();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::ConstIterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::cend() const
+{
+    return end();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::find(const Key& key)
+{
+    size_t pos = findIndex(key, mixHash(hashFunction(key)));
+    return Iterator(ctrl + pos, slots + pos);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::ConstIterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::find(const Key& key) const
+{
+    size_t pos = findIndex(key, mixHash(hashFunction(key)));
+    return ConstIterator(ctrl + pos, slots + pos);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+Value& FlatHashMap<Key, Value, Hash, Equal, Alloc>::operator[](const Key& key)
+{
+    size_t hash = mixHash(hashFunction(key));
+    size_t pos = findIndex(key, hash);
+    if (pos == slotsCnt)
+    {
+        pos = constructAt(hash, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
+    }
+    return slots[pos].second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+Value& FlatHashMap<Key, Value, Hash, Equal, Alloc>::at(const Key& key)
+{
+    Iterator it = find(key);
+    if (it == end())
+    {
+        throw std::out_of_range("out_of_range");
+    }
+    return it -> second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+const Value& FlatHashMap<Key, Value, Hash, Equal, Alloc>::at(const Key& key) const
+{
+    ConstIterator it = find(key);
+    if (it == end())
+    {
+        throw std::out_of_range("out_of_range");
+    }
+    return it -> second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+std::pair<typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::insert(NodeType&& node)
+{
+    return insert<NodeType>(std::move(node));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Pair>
+std::pair<typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::insert(Pair&& pair)
+{
+    const Key& key = pair.first;
+    size_t hash = mixHash(hashFunction(key));
+    size_t pos = findIndex(key, hash);
+    if (pos != slotsCnt)
+    {
+        return {Iterator(ctrl + pos, slots + pos), false};
+    }
+    pos = constructAt(hash, std::forward<Pair>(pair));
+    return {Iterator(ctrl + pos, slots + pos), true};
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename InputIt>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::insert(InputIt first, InputIt last)
+{
+    for (InputIt it = first; it != last; ++it)
+    {
+        insert(*it);
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename... Args>
+std::pair<typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::emplace(Args&&... args)
+{
+    return insert(NodeType(std::forward<Args>(args)...));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::erase(Iterator it)
+{
+    size_t pos = it.slot - slots;
+    AllocTraits::destroy(alloc, slots + pos);
+    auto emptyBefore = CtrlGroup(ctrl + ((pos - CtrlGroup::width) & slotsCnt)).matchEmpty();
+    auto emptyAfter = CtrlGroup(ctrl + pos).matchEmpty();
+    if (static_cast<size_t>(emptyBefore.leadingZeros() + emptyAfter.trailingZeros()) < CtrlGroup::width)
+    {
+        setCtrl(pos, ctrlEmpty);
+    }
+    else
+    {
+        setCtrl(pos, ctrlDeleted);
+        ++deletedCnt;
+    }
+    --sz;
+    Iterator next(ctrl + pos, slots + pos);
+    next.skipFree();
+    return next;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::Iterator FlatHashMap<Key, Value, Hash, Equal, Alloc>::erase(Iterator first, Iterator last)
+{
+    Iterator it = first;
+    for (; it != last; it = erase(it));
+    return it;
+}
+
+//////////////////////////////////////////////////////////////
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::MapIterator(const int8_t* ctrl, NodeType* slot) :
+        ctrl(ctrl),
+        slot(slot) {}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+void FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::skipFree()
+{
+    while (*ctrl < ctrlSentinel)
+    {
+        ++ctrl;
+        ++slot;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>::reference
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator*() const
+{
+    return *slot;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>::pointer
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator->() const
+{
+    return slot;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>&
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator++()
+{
+    ++ctrl;
+    ++slot;
+    skipFree();
+    return *this;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+typename FlatHashMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>
+FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator++(int)
+{
+    MapIterator copyPtr = *this;
+    ++(*this);
+    return copyPtr;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+bool FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator==(const MapIterator& another) const
+{
+    return (ctrl == another.ctrl);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<bool isConst>
+bool FlatHashMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator!=(const MapIterator& another) const
+{
+    return !(*this == another);
+}
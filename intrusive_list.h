@@ -0,0 +1,440 @@
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+struct IntrusiveListHook
+{
+    IntrusiveListHook() = default;
+    IntrusiveListHook(const IntrusiveListHook&) {}
+    IntrusiveListHook& operator=(const IntrusiveListHook&) { return *this; }
+    ~IntrusiveListHook() { assert(!isLinked()); }
+
+    bool isLinked() const { return next != nullptr; }
+
+    IntrusiveListHook* prev = nullptr;
+    IntrusiveListHook* next = nullptr;
+};
+
+template<typename T>
+struct BaseHook
+{
+    static IntrusiveListHook* toHook(T& value)
+    {
+        return &value;
+    }
+
+    static T* fromHook(IntrusiveListHook* hook)
+    {
+        return static_cast<T*>(hook);
+    }
+};
+
+template<typename T, IntrusiveListHook T::* member>
+struct MemberHook
+{
+    static IntrusiveListHook* toHook(T& value)
+    {
+        return &(value.*member);
+    }
+
+    static T* fromHook(IntrusiveListHook* hook)
+    {
+        return reinterpret_cast<T*>(reinterpret_cast<int8_t*>(hook) - offset());
+    }
+
+private:
+    static std::ptrdiff_t offset()
+    {
+        alignas(T) static const int8_t storage[sizeof(T)] = {};
+        const T* object = reinterpret_cast<const T*>(storage);
+        return reinterpret_cast<const int8_t*>(std::addressof(object ->* member)) - storage;
+    }
+};
+
+///////////////////////////////////////////////////////////////////
+template<typename T, typename Hook = BaseHook<T>>
+class IntrusiveList
+{
+private:
+    IntrusiveListHook fakeTail;
+    size_t sz = 0;
+
+    void linkBefore(IntrusiveListHook* pos, IntrusiveListHook* node);
+    void unlink(IntrusiveListHook* node);
+
+public:
+    IntrusiveList();
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList(IntrusiveList&& another);
+    ~IntrusiveList();
+
+    template <bool isConst>
+    class common_iterator
+    {
+    public:
+        friend IntrusiveList;
+
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename std::conditional<isConst, const T, T>::type;
+        using pointer = typename std::conditional<isConst, const T*, T*>::type;
+        using reference = typename std::conditional<isConst, const T&, T&>::type;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        common_iterator(const common_iterator& another) = default;
+        ~common_iterator() = default;
+
+        std::conditional_t<isConst, const T&, T&> operator*() const;
+        std::conditional_t<isConst, const T*, T*> operator->() const;
+        common_iterator& operator++();
+        common_iterator operator++(int);
+        common_iterator& operator--();
+        common_iterator operator--(int);
+        common_iterator& operator=(const common_iterator& another) = default;
+
+        bool operator==(const common_iterator &another) const;
+        bool operator!=(const common_iterator &another) const;
+
+        operator common_iterator<true>() const;
+
+    private:
+        IntrusiveListHook* ptr = nullptr;
+
+        explicit common_iterator(IntrusiveListHook* p);
+    };
+    using iterator = common_iterator<false>;
+    using const_iterator = common_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(IntrusiveList&& another);
+
+    T& front();
+    T& back();
+    iterator iterator_to(T& value);
+    iterator insert(const_iterator it, T& value);
+    iterator erase(const_iterator it);
+    void erase(T& value);
+    void push_back(T& value);
+    void push_front(T& value);
+    void pop_back();
+    void pop_front();
+    void splice(const_iterator pos, IntrusiveList& another);
+    void clear();
+    bool empty() const;
+    size_t size() const;
+};
+
+//////////////////////////////////////////
+template<typename T, typename Hook>
+IntrusiveList<T, Hook>::IntrusiveList()
+{
+    fakeTail.prev = &fakeTail;
+    fakeTail.next = &fakeTail;
+}
+
+template<typename T, typename Hook>
+IntrusiveList<T, Hook>::IntrusiveList(IntrusiveList&& another) : IntrusiveList()
+{
+    splice(cend(), another);
+}
+
+template<typename T, typename Hook>
+IntrusiveList<T, Hook>::~IntrusiveList()
+{
+    clear();
+    fakeTail.prev = nullptr;
+    fakeTail.next = nullptr;
+}
+
+template<typename T, typename Hook>
+IntrusiveList<T, Hook>& IntrusiveList<T, Hook>::operator=(IntrusiveList&& another)
+{
+    if (this != &another)
+    {
+        clear();
+        splice(cend(), another);
+    }
+    return *this;
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::linkBefore(IntrusiveListHook* pos, IntrusiveListHook* node)
+{
+    assert(!node -> isLinked());
+    node -> next = pos;
+    node -> prev = pos -> prev;
+    pos -> prev -> next = node;
+    pos -> prev = node;
+    sz++;
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::unlink(IntrusiveListHook* node)
+{
+    node -> prev -> next = node -> next;
+    node -> next -> prev = node -> prev;
+    node -> prev = nullptr;
+    node -> next = nullptr;
+    sz--;
+}
+
+template<typename T, typename Hook>
+T& IntrusiveList<T, Hook>::front()
+{
+    return *Hook::fromHook(fakeTail.next);
+}
+
+template<typename T, typename Hook>
+T& IntrusiveList<T, Hook>::back()
+{
+    return *Hook::fromHook(fakeTail.prev);
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::iterator_to(T& value)
+{
+    return iterator(Hook::toHook(value));
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::insert(const_iterator it, T& value)
+{
+    IntrusiveListHook* node = Hook::toHook(value);
+    linkBefore(it.ptr, node);
+    return iterator(node);
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::erase(const_iterator it)
+{
+    IntrusiveListHook* next = it.ptr -> next;
+    unlink(it.ptr);
+    return iterator(next);
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::erase(T& value)
+{
+    assert(Hook::toHook(value) -> isLinked());
+    unlink(Hook::toHook(value));
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::push_back(T& value)
+{
+    linkBefore(&fakeTail, Hook::toHook(value));
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::push_front(T& value)
+{
+    linkBefore(fakeTail.next, Hook::toHook(value));
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::pop_back()
+{
+    unlink(fakeTail.prev);
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::pop_front()
+{
+    unlink(fakeTail.next);
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::splice(const_iterator pos, IntrusiveList& another)
+{
+    if (this == &another || another.sz == 0)
+    {
+        return;
+    }
+    IntrusiveListHook* first = another.fakeTail.next;
+    IntrusiveListHook* last = another.fakeTail.prev;
+    another.fakeTail.next = &another.fakeTail;
+    another.fakeTail.prev = &another.fakeTail;
+
+    IntrusiveListHook* node = pos.ptr;
+    first -> prev = node -> prev;
+    last -> next = node;
+    node -> prev -> next = first;
+    node -> prev = last;
+    sz += another.sz;
+    another.sz = 0;
+}
+
+template<typename T, typename Hook>
+void IntrusiveList<T, Hook>::clear()
+{
+    while (sz != 0)
+    {
+        pop_back();
+    }
+}
+
+template<typename T, typename Hook>
+bool IntrusiveList<T, Hook>::empty() const
+{
+    return sz == 0;
+}
+
+template<typename T, typename Hook>
+size_t IntrusiveList<T, Hook>::size() const
+{
+    return sz;
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::begin()
+{
+    return iterator(fakeTail.next);
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::end()
+{
+    return iterator(&fakeTail);
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::const_iterator IntrusiveList<T, Hook>::begin() const
+{
+    return const_iterator(fakeTail.next);
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::const_iterator IntrusiveList<T, Hook>::end() const
+{
+    return const_iterator(const_cast<IntrusiveListHook*>(&fakeTail));
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::const_iterator IntrusiveList<T, Hook>::cbegin() const
+{
+    return begin();
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::const_iterator IntrusiveList<T, Hook>::cend() const
+{
+    return end();
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::reverse_iterator IntrusiveList<T, Hook>::rbegin()
+{
+    return std::make_reverse_iterator(end());
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::reverse_iterator IntrusiveList<T, Hook>::rend()
+{
+    return std::make_reverse_iterator(begin());
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::const_reverse_iterator IntrusiveList<T, Hook>::rbegin() const
+{
+    return std::make_reverse_iterator(end());
+}
+
+template<typename T, typename Hook>
+typename IntrusiveList<T, Hook>::const_reverse_iterator IntrusiveList<T, Hook>::rend() const
+{
+    return std::make_reverse_iterator(begin());
+}
+
+///////////////////////////////////////////////
+template<typename T, typename Hook>
+template<bool isConst>
+IntrusiveList<T, Hook>::common_iterator<isConst>::common_iterator(IntrusiveListHook* p)
+{
+    ptr = p;
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+std::conditional_t<isConst, const T&, T&> IntrusiveList<T, Hook>::common_iterator<isConst>::operator*() const
+{
+    return *Hook::fromHook(ptr);
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+std::conditional_t<isConst, const T*, T*> IntrusiveList<T, Hook>::common_iterator<isConst>::operator->() const
+{
+    return Hook::fromHook(ptr);
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+typename IntrusiveList<T, Hook>::template common_iterator<isConst>& IntrusiveList<T, Hook>::common_iterator<isConst>::operator++()
+{
+    ptr = ptr -> next;
+    return *this;
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+typename IntrusiveList<T, Hook>::template common_iterator<isConst> IntrusiveList<T, Hook>::common_iterator<isConst>::operator++(int)
+{
+    common_iterator copyPtr = *this;
+    ptr = ptr -> next;
+    return copyPtr;
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+typename IntrusiveList<T, Hook>::template common_iterator<isConst>& IntrusiveList<T, Hook>::common_iterator<isConst>::operator--()
+{
+    ptr = ptr -> prev;
+    return *this;
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+typename IntrusiveList<T, Hook>::template common_iterator<isConst> IntrusiveList<T, Hook>::common_iterator<isConst>::operator--(int)
+{
+    common_iterator copyPtr = *this;
+    ptr = ptr -> prev;
+    return copyPtr;
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+bool IntrusiveList<T, Hook>::common_iterator<isConst>::operator==(const common_iterator &another) const
+{
+    return (ptr == another.ptr);
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+bool IntrusiveList<T, Hook>::common_iterator<isConst>::operator!=(const common_iterator &another) const
+{
+    return !(*this == another);
+}
+
+template<typename T, typename Hook>
+template<bool isConst>
+IntrusiveList<T, Hook>::common_iterator<isConst>::operator common_iterator<true>() const
+{
+    return common_iterator<true>(ptr);
+}
@@ -0,0 +1,91 @@
+// g++ -std=c++17 -g list_test.cpp -o list_test && ./list_test
+
+#include "fastallocator.h"
+#include <cassert>
+
+using FastList = List<int, FastAllocator<int>>;
+
+template<typename Allocator>
+std::vector<const int*> addresses(const List<int, Allocator>& list)
+{
+    std::vector<const int*> result;
+    for (const int& value : list)
+    {
+        result.push_back(&value);
+    }
+    return result;
+}
+
+template<typename Allocator>
+void testSplice()
+{
+    Allocator alloc;
+    List<int, Allocator> a(alloc);
+    List<int, Allocator> b(alloc);
+    for (int i = 0; i < 4; ++i)
+    {
+        a.push_back(i);
+        b.push_back(10 + i);
+    }
+    assert(a.get_allocator() == b.get_allocator());
+    std::vector<const int*> expected = addresses(a);
+    std::vector<const int*> moved = addresses(b);
+    expected.insert(expected.begin() + 2, moved.begin(), moved.end());
+
+    a.splice(std::next(a.cbegin(), 2), b);
+    assert(b.size() == 0);
+    assert(addresses(a) == expected);
+}
+
+template<typename Allocator>
+void testMerge()
+{
+    Allocator alloc;
+    List<int, Allocator> a(alloc);
+    List<int, Allocator> b(alloc);
+    for (int i = 0; i < 8; ++i)
+    {
+        (i % 2 == 0 ? a : b).push_back(i);
+    }
+    std::vector<const int*> expected;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        expected.push_back(addresses(a)[i]);
+        expected.push_back(addresses(b)[i]);
+    }
+
+    a.merge(b);
+    assert(b.size() == 0);
+    assert(addresses(a) == expected);
+    int next = 0;
+    for (int value : a)
+    {
+        assert(value == next++);
+    }
+}
+
+void testNodeHandles()
+{
+    FastAllocator<int> alloc;
+    FastList a(alloc);
+    FastList b(alloc);
+    a.push_back(1);
+    const int* address = &*a.begin();
+    b.insert(b.cend(), a.extract(a.cbegin()));
+    assert(a.size() == 0 && b.size() == 1);
+    assert(&*b.begin() == address);
+
+    FastList foreign;
+    foreign.insert(foreign.cend(), b.extract(b.cbegin()));
+    assert(foreign.size() == 1 && *foreign.begin() == 1);
+}
+
+int main()
+{
+    testSplice<FastAllocator<int>>();
+    testSplice<NumaAllocator<int>>();
+    testMerge<FastAllocator<int>>();
+    testMerge<NumaAllocator<int>>();
+    testNodeHandles();
+    std::cout << "ok" << std::endl;
+}
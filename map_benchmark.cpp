@@ -0,0 +1,325 @@
+// g++ -std=c++17 -O2 -DNDEBUG map_benchmark.cpp -o map_benchmark && ./map_benchmark [maxCount]
+
+#include "flat_hash_map.h"
+#include "unordered_map.h"
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+volatile size_t sink;
+
+template<typename Func>
+double nsPerOp(size_t ops, Func func)
+{
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / ops;
+}
+
+void report(const char* name, const char* operation, size_t count, double ns)
+{
+    std::cout << std::left << std::setw(30) << name
+              << std::right << std::setw(10) << count
+              << "  " << std::left << std::setw(14) << operation
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << ns << std::endl;
+}
+
+template<typename Policy>
+void runReduction(const char* name, size_t count)
+{
+    Policy policy(count);
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> hashes(1 << 16);
+    for (uint64_t& hash : hashes)
+    {
+        hash = random();
+    }
+    const size_t rounds = 64;
+    double ns = nsPerOp(rounds * hashes.size(), [&]()
+    {
+        size_t sum = 0;
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            for (uint64_t hash : hashes)
+            {
+                sum += policy.index(hash + sum);
+            }
+        }
+        sink = sum;
+    });
+    report(name, "index", policy.bucketCount(), ns);
+}
+
+template<typename Map>
+void runLookups(const char* name, size_t count, bool sequentialKeys)
+{
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = sequentialKeys ? i : random();
+    }
+    Map map;
+    for (size_t i = 0; i < count; ++i)
+    {
+        map[keys[i]] = i;
+    }
+    std::vector<uint64_t> probes(std::max<size_t>(count, 1 << 20));
+    for (uint64_t& probe : probes)
+    {
+        probe = keys[random() % count];
+    }
+
+    double hitNs = nsPerOp(probes.size(), [&]()
+    {
+        size_t found = 0;
+        for (uint64_t probe : probes)
+        {
+            found += map.find(probe) != map.end();
+        }
+        sink = found;
+    });
+    report(name, sequentialKeys ? "hit_seq" : "hit_random", count, hitNs);
+
+    double missNs = nsPerOp(probes.size(), [&]()
+    {
+        size_t found = 0;
+        for (uint64_t probe : probes)
+        {
+            found += map.find(~probe) != map.end();
+        }
+        sink = found;
+    });
+    report(name, sequentialKeys ? "miss_seq" : "miss_random", count, missNs);
+}
+
+template<typename Policy>
+using PolicyMap = UnorderedMap<uint64_t, uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>, std::allocator<std::pair<const uint64_t, uint64_t>>, Policy>;
+
+template<bool storeHash>
+using StringMap = UnorderedMap<std::string, uint64_t, std::hash<std::string>, std::equal_to<std::string>, std::allocator<std::pair<const std::string, uint64_t>>, ModuloBucketPolicy, storeHash>;
+
+template<typename Map>
+void runStringKeys(const char* name, size_t count)
+{
+    std::mt19937_64 random(42);
+    std::vector<std::string> keys(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = "/service/routing/table/entry/" + std::to_string(random());
+    }
+    std::vector<std::string> probes(std::max<size_t>(count, 1 << 20));
+    for (std::string& probe : probes)
+    {
+        probe = keys[random() % count];
+    }
+
+    Map map;
+    double insertNs = nsPerOp(count, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            map.emplace(keys[i], i);
+        }
+    });
+    report(name, "insert_string", count, insertNs);
+
+    double hitNs = nsPerOp(probes.size(), [&]()
+    {
+        size_t found = 0;
+        for (const std::string& probe : probes)
+        {
+            found += map.find(probe) != map.end();
+        }
+        sink = found;
+    });
+    report(name, "hit_string", count, hitNs);
+}
+
+void runUpserts(size_t count)
+{
+    using Map = UnorderedMap<std::string, uint64_t>;
+    std::mt19937_64 random(42);
+    std::vector<std::string> keys(count);
+    for (std::string& key : keys)
+    {
+        key = "/service/routing/table/entry/" + std::to_string(random());
+    }
+
+    Map map;
+    double fillNs = nsPerOp(count, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            map[keys[i]] = i;
+        }
+    });
+    report("UnorderedMap<string>", "subscript_miss", count, fillNs);
+
+    double subscriptNs = nsPerOp(count, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            ++map[keys[i]];
+        }
+    });
+    report("UnorderedMap<string>", "subscript_hit", count, subscriptNs);
+
+    double emplaceNs = nsPerOp(count, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            map.emplace(keys[i], i);
+        }
+    });
+    report("UnorderedMap<string>", "emplace_hit", count, emplaceNs);
+
+    double tryEmplaceNs = nsPerOp(count, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            map.try_emplace(keys[i], i);
+        }
+    });
+    report("UnorderedMap<string>", "try_emplace_hit", count, tryEmplaceNs);
+}
+
+void runBatchLookups(size_t count)
+{
+    using Map = UnorderedMap<uint64_t, uint64_t>;
+    const size_t batchSz = 256;
+    std::mt19937_64 random(42);
+    std::vector<Map::NodeType> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        values.emplace_back(random(), i);
+    }
+
+    Map map;
+    double insertNs = nsPerOp(count, [&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            map.insert(values[i]);
+        }
+    });
+    report("UnorderedMap", "insert_loop", count, insertNs);
+
+    Map batchMap;
+    double insertBatchNs = nsPerOp(count, [&]()
+    {
+        for (size_t first = 0; first < count; first += batchSz)
+        {
+            batchMap.insert_batch(values.data() + first, std::min(batchSz, count - first));
+        }
+    });
+    report("UnorderedMap", "insert_batch", count, insertBatchNs);
+
+    std::vector<uint64_t> probes(std::max<size_t>(count, 1 << 20));
+    for (uint64_t& probe : probes)
+    {
+        probe = values[random() % count].first;
+    }
+    std::vector<Map::Iterator> results(probes.size());
+
+    double findNs = nsPerOp(probes.size(), [&]()
+    {
+        for (size_t i = 0; i < probes.size(); ++i)
+        {
+            results[i] = map.find(probes[i]);
+        }
+    });
+    report("UnorderedMap", "find_loop", count, findNs);
+
+    double batchNs = nsPerOp(probes.size(), [&]()
+    {
+        for (size_t first = 0; first < probes.size(); first += batchSz)
+        {
+            map.find_batch(probes.data() + first, std::min(batchSz, probes.size() - first), results.data() + first);
+        }
+    });
+    report("UnorderedMap", "find_batch", count, batchNs);
+}
+
+using TransparentMap = UnorderedMap<std::string, uint64_t, TransparentStringHash, TransparentStringEqual>;
+
+void runTransparentLookups(size_t count)
+{
+    std::mt19937_64 random(42);
+    TransparentMap map;
+    std::vector<std::string> keys(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = "/service/routing/table/entry/" + std::to_string(random());
+        map[keys[i]] = i;
+    }
+    std::vector<const char*> probes(std::max<size_t>(count, 1 << 20));
+    for (const char*& probe : probes)
+    {
+        probe = keys[random() % count].c_str();
+    }
+
+    double temporaryNs = nsPerOp(probes.size(), [&]()
+    {
+        size_t found = 0;
+        for (const char* probe : probes)
+        {
+            found += map.find(std::string(probe)) != map.end();
+        }
+        sink = found;
+    });
+    report("UnorderedMap<transparent>", "find_temporary", count, temporaryNs);
+
+    double cstrNs = nsPerOp(probes.size(), [&]()
+    {
+        size_t found = 0;
+        for (const char* probe : probes)
+        {
+            found += map.find(probe) != map.end();
+        }
+        sink = found;
+    });
+    report("UnorderedMap<transparent>", "find_cstr", count, cstrNs);
+}
+
+void runSize(size_t count)
+{
+    runReduction<ModuloBucketPolicy>("ModuloBucketPolicy", count);
+    runReduction<PowerOfTwoBucketPolicy>("PowerOfTwoBucketPolicy", count);
+    runReduction<FastRangeBucketPolicy>("FastRangeBucketPolicy", count);
+    runReduction<PrimeBucketPolicy>("PrimeBucketPolicy", count);
+
+    for (bool sequentialKeys : {false, true})
+    {
+        runLookups<PolicyMap<ModuloBucketPolicy>>("UnorderedMap<Modulo>", count, sequentialKeys);
+        runLookups<PolicyMap<PowerOfTwoBucketPolicy>>("UnorderedMap<PowerOfTwo>", count, sequentialKeys);
+        runLookups<PolicyMap<FastRangeBucketPolicy>>("UnorderedMap<FastRange>", count, sequentialKeys);
+        runLookups<PolicyMap<PrimeBucketPolicy>>("UnorderedMap<Prime>", count, sequentialKeys);
+        runLookups<FlatHashMap<uint64_t, uint64_t>>("FlatHashMap", count, sequentialKeys);
+    }
+
+    runStringKeys<StringMap<false>>("UnorderedMap<string>", count);
+    runStringKeys<StringMap<true>>("UnorderedMap<string, stored>", count);
+    runTransparentLookups(count);
+    runUpserts(count);
+    runBatchLookups(count);
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::cout << std::left << std::setw(30) << "container"
+              << std::right << std::setw(10) << "count"
+              << "  " << std::left << std::setw(14) << "operation"
+              << std::right << std::setw(10) << "ns/op" << std::endl;
+
+    for (size_t count = 1000; count <= maxCount; count *= 10)
+    {
+        runSize(count);
+    }
+}
@@ -0,0 +1,140 @@
+// g++ -std=c++17 -O2 -DNDEBUG -pthread queue_benchmark.cpp -o queue_benchmark && ./queue_benchmark [maxThreads]
+
+#include "concurrent_queue.h"
+#include <chrono>
+#include <iomanip>
+
+const size_t itemsPerProducer = 1 << 18;
+
+class LockedList
+{
+public:
+    void push(uint64_t value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        list.push_back(value);
+    }
+
+    bool try_pop(uint64_t& out)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (list.size() == 0)
+        {
+            return false;
+        }
+        out = *list.begin();
+        list.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex lock;
+    List<uint64_t> list;
+};
+
+class Bounded
+{
+public:
+    void push(uint64_t value)
+    {
+        while (!queue.try_push(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    bool try_pop(uint64_t& out)
+    {
+        return queue.try_pop(out);
+    }
+
+private:
+    BoundedQueue<uint64_t> queue{1 << 12};
+};
+
+template<typename Queue>
+double runWorkload(size_t pairsCnt, bool& valid)
+{
+    Queue queue;
+    std::atomic<bool> start{false};
+    std::atomic<size_t> popped{0};
+    std::atomic<uint64_t> sum{0};
+    const size_t total = pairsCnt * itemsPerProducer;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < pairsCnt; ++t)
+    {
+        threads.emplace_back([&queue, &start, t]()
+        {
+            while (!start.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < itemsPerProducer; ++i)
+            {
+                queue.push(t * itemsPerProducer + i);
+            }
+        });
+        threads.emplace_back([&queue, &start, &popped, &sum, total]()
+        {
+            uint64_t localSum = 0;
+            uint64_t value;
+            while (!start.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            while (popped.load(std::memory_order_relaxed) < total)
+            {
+                if (queue.try_pop(value))
+                {
+                    localSum += value;
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            sum.fetch_add(localSum, std::memory_order_relaxed);
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    valid = sum.load() == total * (total - 1) / 2;
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+template<typename Queue>
+void runScaling(const char* name, size_t maxThreads)
+{
+    for (size_t pairsCnt = 1; 2 * pairsCnt <= maxThreads; pairsCnt *= 2)
+    {
+        bool valid = false;
+        double ms = runWorkload<Queue>(pairsCnt, valid);
+        std::cout << std::left << std::setw(26) << name
+                  << std::right << std::setw(10) << pairsCnt
+                  << std::setw(10) << pairsCnt
+                  << std::fixed << std::setprecision(2) << std::setw(12) << ms
+                  << std::setw(12) << pairsCnt * itemsPerProducer / ms / 1e3
+                  << (valid ? "" : "  checksum mismatch") << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t maxThreads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(26) << "queue"
+              << std::right << std::setw(10) << "producers"
+              << std::setw(10) << "consumers"
+              << std::setw(12) << "ms"
+              << std::setw(12) << "Mitems/s" << std::endl;
+
+    runScaling<LockedList>("List+mutex", maxThreads);
+    runScaling<LockFreeQueue<uint64_t>>("LockFreeQueue", maxThreads);
+    runScaling<Bounded>("BoundedQueue", maxThreads);
+}
@@ -0,0 +1,535 @@
+#pragma once
+
+#include "unordered_map.h"
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <limits>
+
+const float defaultRcuMaxLoadFactor = 1.0;
+const size_t rcuRecordAlignment = 64;
+
+class EpochDomain
+{
+public:
+    static constexpr uint64_t idleEpoch = std::numeric_limits<uint64_t>::max();
+
+    static EpochDomain& global();
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    void enter();
+    void exit();
+    uint64_t advance();
+    uint64_t minActiveEpoch();
+
+private:
+    struct alignas(rcuRecordAlignment) Record
+    {
+        std::atomic<uint64_t> epoch{idleEpoch};
+        std::atomic<bool> inUse{false};
+        Record* next = nullptr;
+    };
+
+    struct ThreadRecord
+    {
+        Record* record = nullptr;
+        size_t depth = 0;
+
+        ~ThreadRecord();
+    };
+
+    alignas(rcuRecordAlignment) std::atomic<uint64_t> epoch{1};
+    std::atomic<Record*> records{nullptr};
+
+    EpochDomain() = default;
+    Record* acquireRecord();
+    static ThreadRecord& threadRecord();
+};
+
+class EpochGuard
+{
+public:
+    EpochGuard();
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+    ~EpochGuard();
+};
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Value>>>
+class RcuHashMap
+{
+public:
+    using NodeType = std::pair<const Key, Value>;
+
+    explicit RcuHashMap(size_t bucketsCount = 16, const Alloc& alloc = Alloc());
+    RcuHashMap(const RcuHashMap&) = delete;
+    RcuHashMap& operator=(const RcuHashMap&) = delete;
+    ~RcuHashMap();
+
+    bool find(const Key& key, Value& out) const;
+    bool contains(const Key& key) const;
+    template<typename Func>
+    bool cvisit(const Key& key, Func func) const;
+    template<typename Func>
+    void cvisit_all(Func func) const;
+
+    template<typename V>
+    bool insert(const Key& key, V&& value);
+    template<typename V>
+    bool insert_or_assign(const Key& key, V&& value);
+    bool erase(const Key& key);
+    void reserve(size_t count);
+    size_t reclaim();
+
+    size_t size() const;
+    size_t bucket_count() const;
+
+private:
+    struct Node
+    {
+        template<typename... Args>
+        Node(size_t hash, Args&&... args) : value(std::forward<Args>(args)...), hash(hash) {}
+
+        NodeType value;
+        size_t hash;
+        std::atomic<Node*> next{nullptr};
+    };
+
+    struct Table
+    {
+        PowerOfTwoBucketPolicy policy;
+        std::atomic<Node*>* buckets;
+    };
+
+    struct Retired
+    {
+        uint64_t epoch;
+        Node* node;
+        Table* table;
+    };
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using NodeAlloc = typename AllocTraits::template rebind_alloc<Node>;
+    using NodeAllocTraits = std::allocator_traits<NodeAlloc>;
+    using TableAlloc = typename AllocTraits::template rebind_alloc<Table>;
+    using TableAllocTraits = std::allocator_traits<TableAlloc>;
+    using BucketAlloc = typename AllocTraits::template rebind_alloc<std::atomic<Node*>>;
+    using BucketAllocTraits = std::allocator_traits<BucketAlloc>;
+
+    std::atomic<Table*> table;
+    std::atomic<size_t> elementsCnt{0};
+    std::mutex writerLock;
+    std::vector<Retired> retired;
+    NodeAlloc nodeAlloc;
+    TableAlloc tableAlloc;
+    BucketAlloc bucketAlloc;
+    Hash hashFunction;
+    Equal equalFunction;
+
+    template<typename... Args>
+    Node* makeNode(size_t hash, Args&&... args);
+    void deleteNode(Node* node);
+    Table* makeTable(size_t count);
+    void deleteTable(Table* oldTable);
+    std::atomic<Node*>* findLink(Table* current, const Key& key, size_t hash);
+    const Node* findNode(const Key& key) const;
+    void growIfNeeded(size_t count);
+    void retire(Node* node, Table* oldTable);
+    size_t freeRetired();
+};
+
+//////////////////////////////////////////
+inline EpochDomain& EpochDomain::global()
+{
+    static EpochDomain domain;
+    return domain;
+}
+
+inline EpochDomain::ThreadRecord::~ThreadRecord()
+{
+    if (record != nullptr)
+    {
+        record -> epoch.store(idleEpoch, std::memory_order_release);
+        record -> inUse.store(false, std::memory_order_release);
+    }
+}
+
+inline EpochDomain::ThreadRecord& EpochDomain::threadRecord()
+{
+    thread_local ThreadRecord current;
+    return current;
+}
+
+inline EpochDomain::Record* EpochDomain::acquireRecord()
+{
+    for (Record* record = records.load(std::memory_order_acquire); record != nullptr; record = record -> next)
+    {
+        bool expected = false;
+        if (!record -> inUse.load(std::memory_order_relaxed) && record -> inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            return record;
+        }
+    }
+    Record* record = new Record();
+    record -> inUse.store(true, std::memory_order_relaxed);
+    Record* head = records.load(std::memory_order_relaxed);
+    do
+    {
+        record -> next = head;
+    }
+    while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+    return record;
+}
+
+inline void EpochDomain::enter()
+{
+    ThreadRecord& current = threadRecord();
+    if (current.depth++ != 0)
+    {
+        return;
+    }
+    if (current.record == nullptr)
+    {
+        current.record = acquireRecord();
+    }
+    current.record -> epoch.store(epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+inline void EpochDomain::exit()
+{
+    ThreadRecord& current = threadRecord();
+    if (--current.depth == 0)
+    {
+        current.record -> epoch.store(idleEpoch, std::memory_order_release);
+    }
+}
+
+inline uint64_t EpochDomain::advance()
+{
+    return epoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+inline uint64_t EpochDomain::minActiveEpoch()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t result = idleEpoch;
+    for (Record* record = records.load(std::memory_order_acquire); record != nullptr; record = record -> next)
+    {
+        result = std::min(result, record -> epoch.load(std::memory_order_acquire));
+    }
+    return result;
+}
+
+inline EpochGuard::EpochGuard()
+{
+    EpochDomain::global().enter();
+}
+
+inline EpochGuard::~EpochGuard()
+{
+    EpochDomain::global().exit();
+}
+
+//////////////////////////////////////////
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+RcuHashMap<Key, Value, Hash, Equal, Alloc>::RcuHashMap(size_t bucketsCount, const Alloc& alloc) :
+        nodeAlloc(alloc),
+        tableAlloc(alloc),
+        bucketAlloc(alloc)
+{
+    table.store(makeTable(bucketsCount), std::memory_order_release);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+RcuHashMap<Key, Value, Hash, Equal, Alloc>::~RcuHashMap()
+{
+    for (Retired& item : retired)
+    {
+        item.node != nullptr ? deleteNode(item.node) : deleteTable(item.table);
+    }
+    deleteTable(table.load(std::memory_order_relaxed));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename... Args>
+typename RcuHashMap<Key, Value, Hash, Equal, Alloc>::Node* RcuHashMap<Key, Value, Hash, Equal, Alloc>::makeNode(size_t hash, Args&&... args)
+{
+    Node* node = NodeAllocTraits::allocate(nodeAlloc, 1);
+    try
+    {
+        NodeAllocTraits::construct(nodeAlloc, node, hash, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        NodeAllocTraits::deallocate(nodeAlloc, node, 1);
+        throw;
+    }
+    return node;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void RcuHashMap<Key, Value, Hash, Equal, Alloc>::deleteNode(Node* node)
+{
+    NodeAllocTraits::destroy(nodeAlloc, node);
+    NodeAllocTraits::deallocate(nodeAlloc, node, 1);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+typename RcuHashMap<Key, Value, Hash, Equal, Alloc>::Table* RcuHashMap<Key, Value, Hash, Equal, Alloc>::makeTable(size_t count)
+{
+    Table* newTable = TableAllocTraits::allocate(tableAlloc, 1);
+    newTable -> policy = PowerOfTwoBucketPolicy(count);
+    size_t bucketsCnt = newTable -> policy.bucketCount();
+    newTable -> buckets = BucketAllocTraits::allocate(bucketAlloc, bucketsCnt);
+    for (size_t i = 0; i < bucketsCnt; ++i)
+    {
+        new(&newTable -> buckets[i]) std::atomic<Node*>(nullptr);
+    }
+    return newTable;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void RcuHashMap<Key, Value, Hash, Equal, Alloc>::deleteTable(Table* oldTable)
+{
+    size_t bucketsCnt = oldTable -> policy.bucketCount();
+    for (size_t i = 0; i < bucketsCnt; ++i)
+    {
+        Node* node = oldTable -> buckets[i].load(std::memory_order_relaxed);
+        while (node != nullptr)
+        {
+            Node* next = node -> next.load(std::memory_order_relaxed);
+            deleteNode(node);
+            node = next;
+        }
+    }
+    BucketAllocTraits::deallocate(bucketAlloc, oldTable -> buckets, bucketsCnt);
+    TableAllocTraits::deallocate(tableAlloc, oldTable, 1);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void RcuHashMap<Key, Value, Hash, Equal, Alloc>::retire(Node* node, Table* oldTable)
+{
+    retired.push_back({EpochDomain::global().advance(), node, oldTable});
+    freeRetired();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t RcuHashMap<Key, Value, Hash, Equal, Alloc>::reclaim()
+{
+    std::lock_guard<std::mutex> guard(writerLock);
+    return freeRetired();
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t RcuHashMap<Key, Value, Hash, Equal, Alloc>::freeRetired()
+{
+    if (retired.empty())
+    {
+        return 0;
+    }
+    uint64_t minEpoch = EpochDomain::global().minActiveEpoch();
+    size_t freed = 0;
+    while (freed < retired.size() && retired[freed].epoch < minEpoch)
+    {
+        Retired& item = retired[freed++];
+        item.node != nullptr ? deleteNode(item.node) : deleteTable(item.table);
+    }
+    retired.erase(retired.begin(), retired.begin() + freed);
+    return freed;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+const typename RcuHashMap<Key, Value, Hash, Equal, Alloc>::Node* RcuHashMap<Key, Value, Hash, Equal, Alloc>::findNode(const Key& key) const
+{
+    size_t hash = hashFunction(key);
+    Table* current = table.load(std::memory_order_acquire);
+    Node* node = current -> buckets[current -> policy.index(hash)].load(std::memory_order_acquire);
+    while (node != nullptr)
+    {
+        if (node -> hash == hash && equalFunction(node -> value.first, key))
+        {
+            return node;
+        }
+        node = node -> next.load(std::memory_order_acquire);
+    }
+    return nullptr;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+std::atomic<typename RcuHashMap<Key, Value, Hash, Equal, Alloc>::Node*>* RcuHashMap<Key, Value, Hash, Equal, Alloc>::findLink(Table* current, const Key& key, size_t hash)
+{
+    std::atomic<Node*>* link = &current -> buckets[current -> policy.index(hash)];
+    Node* node = link -> load(std::memory_order_relaxed);
+    while (node != nullptr)
+    {
+        if (node -> hash == hash && equalFunction(node -> value.first, key))
+        {
+            return link;
+        }
+        link = &node -> next;
+        node = link -> load(std::memory_order_relaxed);
+    }
+    return nullptr;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+bool RcuHashMap<Key, Value, Hash, Equal, Alloc>::find(const Key& key, Value& out) const
+{
+    return cvisit(key, [&out](const Value& value)
+    {
+        out = value;
+    });
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+bool RcuHashMap<Key, Value, Hash, Equal, Alloc>::contains(const Key& key) const
+{
+    EpochGuard guard;
+    return findNode(key) != nullptr;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Func>
+bool RcuHashMap<Key, Value, Hash, Equal, Alloc>::cvisit(const Key& key, Func func) const
+{
+    EpochGuard guard;
+    const Node* node = findNode(key);
+    if (node == nullptr)
+    {
+        return false;
+    }
+    func(node -> value.second);
+    return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Func>
+void RcuHashMap<Key, Value, Hash, Equal, Alloc>::cvisit_all(Func func) const
+{
+    EpochGuard guard;
+    Table* current = table.load(std::memory_order_acquire);
+    size_t bucketsCnt = current -> policy.bucketCount();
+    for (size_t i = 0; i < bucketsCnt; ++i)
+    {
+        for (Node* node = current -> buckets[i].load(std::memory_order_acquire); node != nullptr; node = node -> next.load(std::memory_order_acquire))
+        {
+            func(static_cast<const NodeType&>(node -> value));
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void RcuHashMap<Key, Value, Hash, Equal, Alloc>::growIfNeeded(size_t count)
+{
+    Table* current = table.load(std::memory_order_relaxed);
+    size_t bucketsCnt = current -> policy.bucketCount();
+    if (count <= defaultRcuMaxLoadFactor * bucketsCnt)
+    {
+        return;
+    }
+    Table* newTable = makeTable(static_cast<size_t>(std::ceil(count / defaultRcuMaxLoadFactor)));
+    try
+    {
+        for (size_t i = 0; i < bucketsCnt; ++i)
+        {
+            for (Node* node = current -> buckets[i].load(std::memory_order_relaxed); node != nullptr; node = node -> next.load(std::memory_order_relaxed))
+            {
+                Node* copy = makeNode(node -> hash, node -> value);
+                std::atomic<Node*>& bucket = newTable -> buckets[newTable -> policy.index(node -> hash)];
+                copy -> next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                bucket.store(copy, std::memory_order_relaxed);
+            }
+        }
+    }
+    catch (...)
+    {
+        deleteTable(newTable);
+        throw;
+    }
+    table.store(newTable, std::memory_order_release);
+    retire(nullptr, current);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename V>
+bool RcuHashMap<Key, Value, Hash, Equal, Alloc>::insert(const Key& key, V&& value)
+{
+    std::lock_guard<std::mutex> guard(writerLock);
+    size_t hash = hashFunction(key);
+    if (findLink(table.load(std::memory_order_relaxed), key, hash) != nullptr)
+    {
+        return false;
+    }
+    growIfNeeded(elementsCnt.load(std::memory_order_relaxed) + 1);
+    Table* current = table.load(std::memory_order_relaxed);
+    std::atomic<Node*>& bucket = current -> buckets[current -> policy.index(hash)];
+    Node* node = makeNode(hash, key, std::forward<V>(value));
+    node -> next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    bucket.store(node, std::memory_order_release);
+    elementsCnt.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename V>
+bool RcuHashMap<Key, Value, Hash, Equal, Alloc>::insert_or_assign(const Key& key, V&& value)
+{
+    std::lock_guard<std::mutex> guard(writerLock);
+    size_t hash = hashFunction(key);
+    std::atomic<Node*>* link = findLink(table.load(std::memory_order_relaxed), key, hash);
+    if (link == nullptr)
+    {
+        growIfNeeded(elementsCnt.load(std::memory_order_relaxed) + 1);
+        Table* current = table.load(std::memory_order_relaxed);
+        link = &current -> buckets[current -> policy.index(hash)];
+        Node* node = makeNode(hash, key, std::forward<V>(value));
+        node -> next.store(link -> load(std::memory_order_relaxed), std::memory_order_relaxed);
+        link -> store(node, std::memory_order_release);
+        elementsCnt.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    Node* old = link -> load(std::memory_order_relaxed);
+    Node* node = makeNode(hash, key, std::forward<V>(value));
+    node -> next.store(old -> next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    link -> store(node, std::memory_order_release);
+    retire(old, nullptr);
+    return false;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+bool RcuHashMap<Key, Value, Hash, Equal, Alloc>::erase(const Key& key)
+{
+    std::lock_guard<std::mutex> guard(writerLock);
+    std::atomic<Node*>* link = findLink(table.load(std::memory_order_relaxed), key, hashFunction(key));
+    if (link == nullptr)
+    {
+        return false;
+    }
+    Node* old = link -> load(std::memory_order_relaxed);
+    link -> store(old -> next.load(std::memory_order_relaxed), std::memory_order_release);
+    elementsCnt.fetch_sub(1, std::memory_order_relaxed);
+    retire(old, nullptr);
+    return true;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+void RcuHashMap<Key, Value, Hash, Equal, Alloc>::reserve(size_t count)
+{
+    std::lock_guard<std::mutex> guard(writerLock);
+    growIfNeeded(count);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t RcuHashMap<Key, Value, Hash, Equal, Alloc>::size() const
+{
+    return elementsCnt.load(std::memory_order_relaxed);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+size_t RcuHashMap<Key, Value, Hash, Equal, Alloc>::bucket_count() const
+{
+    return table.load(std::memory_order_acquire) -> policy.bucketCount();
+}
@@ -1,14 +1,42 @@
+#pragma once
+
 #include <vector>
 #include <functional>
 #include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
 
 float defaultMaxLoadFactor = 0.75;
+const size_t incrementalRehashStep = 16;
+const size_t bucketPrepareStep = 64;
+const size_t batchGroupSz = 32;
+
+inline void prefetchMapRead(const void* ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr, 0, 3);
+#endif
+}
 
-template<typename T, typename Allocator>
+template<bool storeHash>
+struct StoredHash
+{
+    size_t hash;
+};
+
+template<>
+struct StoredHash<false> {};
+
+template<typename T, typename Allocator, bool storeHash = false>
 class List
 {
 public:
-    struct Node
+    struct Node : StoredHash<storeHash>
     {
     public:
         template<typename... Args>
@@ -87,9 +115,9 @@ public:
 };
 ////////////////////////////////////////////////////////////////
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<typename... Args>
-typename List<T, Allocator>::Node* List<T, Allocator>::makeNode(Args&& ... args)
+typename List<T, Allocator, storeHash>::Node* List<T, Allocator, storeHash>::makeNode(Args&& ... args)
 {
     Node* node = NodeAllocTraits::allocate(nodeAlloc, 1);
     AllocTraits::construct(typeAlloc, &(node -> value), std::forward<Args>(args)...);
@@ -98,15 +126,15 @@ typename List<T, Allocator>::Node* List<T, Allocator>::makeNode(Args&& ... args)
     return node;
 }
 
-template<typename T, typename Allocator>
-void List<T, Allocator>::deleteNode(Node* node)
+template<typename T, typename Allocator, bool storeHash>
+void List<T, Allocator, storeHash>::deleteNode(Node* node)
 {
     NodeAllocTraits::destroy(nodeAlloc, node);
     NodeAllocTraits::deallocate(nodeAlloc, node, 1);
 }
 
-template<typename T, typename Allocator>
-List<T, Allocator>::List(const Allocator& alloc) : sz(0), typeAlloc(alloc), nodeAlloc(alloc)
+template<typename T, typename Allocator, bool storeHash>
+List<T, Allocator, storeHash>::List(const Allocator& alloc) : sz(0), typeAlloc(alloc), nodeAlloc(alloc)
 {
     fakeTail = reinterpret_cast<Node*> (new int8_t[sizeof(Node)]);
     fakeTail -> next = nullptr;
@@ -114,8 +142,8 @@ List<T, Allocator>::List(const Allocator& alloc) : sz(0), typeAlloc(alloc), node
     head = fakeTail;
 }
 
-template<typename T, typename Allocator>
-List<T, Allocator>::List(size_t count, const T& value, const Allocator& alloc) : List(alloc)
+template<typename T, typename Allocator, bool storeHash>
+List<T, Allocator, storeHash>::List(size_t count, const T& value, const Allocator& alloc) : List(alloc)
 {
     for (size_t i = 0; i < count; ++i)
     {
@@ -123,20 +151,24 @@ List<T, Allocator>::List(size_t count, const T& value, const Allocator& alloc) :
     }
 }
 
-template<typename T, typename Allocator>
-List<T, Allocator>::List(const List& another) : List(std::allocator_traits<Allocator>::select_on_container_copy_construction(another.typeAlloc))
+template<typename T, typename Allocator, bool storeHash>
+List<T, Allocator, storeHash>::List(const List& another) : List(std::allocator_traits<Allocator>::select_on_container_copy_construction(another.typeAlloc))
 {
     Node *node = another.head;
     for (size_t i = 0; i < another . sz; ++i)
     {
         Node* newNode = makeNode(node -> value);
+        if constexpr (storeHash)
+        {
+            newNode -> hash = node -> hash;
+        }
         insert(cend(), newNode);
         node = node -> next;
     }
 }
 
-template<typename T, typename Allocator>
-void List<T, Allocator>::Swap(List& another)
+template<typename T, typename Allocator, bool storeHash>
+void List<T, Allocator, storeHash>::Swap(List& another)
 {
     std::swap(head, another.head);
     std::swap(fakeTail, another.fakeTail);
@@ -145,14 +177,14 @@ void List<T, Allocator>::Swap(List& another)
     std::swap(nodeAlloc, another.nodeAlloc);
 }
 
-template<typename T, typename Allocator>
-List<T, Allocator>::List(List&& another) : List()
+template<typename T, typename Allocator, bool storeHash>
+List<T, Allocator, storeHash>::List(List&& another) : List()
 {
     Swap(another);
 }
 
-template<typename T, typename Allocator>
-List<T, Allocator>::~List()
+template<typename T, typename Allocator, bool storeHash>
+List<T, Allocator, storeHash>::~List()
 {
     size_t cnt = sz;
     for (size_t i = 0; i < cnt; ++i)
@@ -164,8 +196,8 @@ List<T, Allocator>::~List()
     delete[] reinterpret_cast<int8_t*>(fakeTail);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::iterator List<T, Allocator>::insert(const_iterator it, Node* node)
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::iterator List<T, Allocator, storeHash>::insert(const_iterator it, Node* node)
 {
     sz++;
     node -> next = it.getPointer();
@@ -183,8 +215,8 @@ typename List<T, Allocator>::iterator List<T, Allocator>::insert(const_iterator
     return iterator(node);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::Node* List<T, Allocator>::extractNode(iterator it)
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::Node* List<T, Allocator, storeHash>::extractNode(iterator it)
 {
     Node* node = it.getPointer();
     sz--;
@@ -202,8 +234,8 @@ typename List<T, Allocator>::Node* List<T, Allocator>::extractNode(iterator it)
     return node;
 }
 
-template<typename T, typename Allocator>
-void List<T, Allocator>::erase(const_iterator it)
+template<typename T, typename Allocator, bool storeHash>
+void List<T, Allocator, storeHash>::erase(const_iterator it)
 {
     Node* node = it.getPointer();
     sz--;
@@ -222,171 +254,316 @@ void List<T, Allocator>::erase(const_iterator it)
 }
 
 ////////////////////////////////////////////////////////////////
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-List<T, Allocator>::common_iterator<isConst>::common_iterator(Node* p)
+List<T, Allocator, storeHash>::common_iterator<isConst>::common_iterator(Node* p)
 {
     ptr = p;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
 template<bool>
-List<T, Allocator>::common_iterator<isConst>::common_iterator(const common_iterator<false>& another)
+List<T, Allocator, storeHash>::common_iterator<isConst>::common_iterator(const common_iterator<false>& another)
 {
     ptr = another.getPointer();
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-List<T, Allocator>::common_iterator<isConst>::common_iterator(const common_iterator& another)
+List<T, Allocator, storeHash>::common_iterator<isConst>::common_iterator(const common_iterator& another)
 {
     ptr = another.getPointer();
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-std::conditional_t<isConst, const T&, T&> List<T, Allocator>::common_iterator<isConst>::operator*() const
+std::conditional_t<isConst, const T&, T&> List<T, Allocator, storeHash>::common_iterator<isConst>::operator*() const
 {
     return ptr -> value;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-std::conditional_t<isConst, const T*, T*> List<T, Allocator>::common_iterator<isConst>::operator->()
+std::conditional_t<isConst, const T*, T*> List<T, Allocator, storeHash>::common_iterator<isConst>::operator->()
 {
     return &(ptr -> value);
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-typename List<T, Allocator>::template common_iterator<isConst>& List<T, Allocator>::common_iterator<isConst>::operator++()
+typename List<T, Allocator, storeHash>::template common_iterator<isConst>& List<T, Allocator, storeHash>::common_iterator<isConst>::operator++()
 {
     ptr = ptr -> next;
     return *this;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-typename List<T, Allocator>::template common_iterator<isConst> List<T, Allocator>::common_iterator<isConst>::operator++(int)
+typename List<T, Allocator, storeHash>::template common_iterator<isConst> List<T, Allocator, storeHash>::common_iterator<isConst>::operator++(int)
 {
     common_iterator copyPtr = *this;
     ptr = ptr -> next;
     return copyPtr;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-typename List<T, Allocator>::template common_iterator<isConst>& List<T, Allocator>::common_iterator<isConst>::operator--()
+typename List<T, Allocator, storeHash>::template common_iterator<isConst>& List<T, Allocator, storeHash>::common_iterator<isConst>::operator--()
 {
     ptr = ptr -> prev;
     return *this;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-typename List<T, Allocator>::template common_iterator<isConst> List<T, Allocator>::common_iterator<isConst>::operator--(int)
+typename List<T, Allocator, storeHash>::template common_iterator<isConst> List<T, Allocator, storeHash>::common_iterator<isConst>::operator--(int)
 {
     common_iterator copyPtr = *this;
     ptr = ptr -> prev;
     return copyPtr;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-typename List<T, Allocator>::template common_iterator<isConst>& List<T, Allocator>::common_iterator<isConst>::operator=(const common_iterator<isConst>& another)
+typename List<T, Allocator, storeHash>::template common_iterator<isConst>& List<T, Allocator, storeHash>::common_iterator<isConst>::operator=(const common_iterator<isConst>& another)
 {
     ptr = another.ptr;
     return *this;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
 template<bool>
-typename List<T, Allocator>::template common_iterator<isConst>& List<T, Allocator>::common_iterator<isConst>::operator=(const common_iterator<false>& another)
+typename List<T, Allocator, storeHash>::template common_iterator<isConst>& List<T, Allocator, storeHash>::common_iterator<isConst>::operator=(const common_iterator<false>& another)
 {
     ptr = another.ptr;
     return *this;
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-bool List<T, Allocator>::common_iterator<isConst>::operator==(const common_iterator &another) const
+bool List<T, Allocator, storeHash>::common_iterator<isConst>::operator==(const common_iterator &another) const
 {
     return (ptr == another.ptr);
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-bool List<T, Allocator>::common_iterator<isConst>::operator!=(const common_iterator &another) const
+bool List<T, Allocator, storeHash>::common_iterator<isConst>::operator!=(const common_iterator &another) const
 {
     return !(*this == another);
 }
 
-template<typename T, typename Allocator>
+template<typename T, typename Allocator, bool storeHash>
 template<bool isConst>
-typename List<T, Allocator>::Node* List<T, Allocator>::common_iterator<isConst>::getPointer() const
+typename List<T, Allocator, storeHash>::Node* List<T, Allocator, storeHash>::common_iterator<isConst>::getPointer() const
 {
     return ptr;
 }
 
 /////////////////////////////////////////////////////////////
-template<typename T, typename Allocator>
-typename List<T, Allocator>::iterator List<T, Allocator>::begin()
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::iterator List<T, Allocator, storeHash>::begin()
 {
     return iterator(head);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::iterator List<T, Allocator>::end()
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::iterator List<T, Allocator, storeHash>::end()
 {
     return iterator(fakeTail);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::const_iterator List<T, Allocator>::begin() const
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::const_iterator List<T, Allocator, storeHash>::begin() const
 {
     return const_iterator(head);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::const_iterator List<T, Allocator>::end() const
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::const_iterator List<T, Allocator, storeHash>::end() const
 {
     return const_iterator(fakeTail);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::const_iterator List<T, Allocator>::cbegin() const
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::const_iterator List<T, Allocator, storeHash>::cbegin() const
 {
     return const_iterator(head);
 }
 
-template<typename T, typename Allocator>
-typename List<T, Allocator>::const_iterator List<T, Allocator>::cend() const
+template<typename T, typename Allocator, bool storeHash>
+typename List<T, Allocator, storeHash>::const_iterator List<T, Allocator, storeHash>::cend() const
 {
     return const_iterator(fakeTail);
 }
 
-template<typename T, typename Allocator>
-size_t List<T, Allocator>::size()
+template<typename T, typename Allocator, bool storeHash>
+size_t List<T, Allocator, storeHash>::size()
 {
     return sz;
 }
 
 ////////////////////////////////////////////////
-template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Value>>>
+inline uint64_t mixBucketHash(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+class ModuloBucketPolicy
+{
+public:
+    explicit ModuloBucketPolicy(size_t requested = 1) : count(std::max<size_t>(requested, 1)) {}
+
+    size_t bucketCount() const
+    {
+        return count;
+    }
+
+    size_t index(size_t hash) const
+    {
+        return hash % count;
+    }
+
+private:
+    size_t count;
+};
+
+class PowerOfTwoBucketPolicy
+{
+public:
+    explicit PowerOfTwoBucketPolicy(size_t requested = 1) : mask(0)
+    {
+        while (mask + 1 < requested)
+        {
+            mask = 2 * mask + 1;
+        }
+    }
+
+    size_t bucketCount() const
+    {
+        return mask + 1;
+    }
+
+    size_t index(size_t hash) const
+    {
+        return mixBucketHash(hash) & mask;
+    }
+
+private:
+    size_t mask;
+};
+
+class FastRangeBucketPolicy
+{
+public:
+    explicit FastRangeBucketPolicy(size_t requested = 1) : count(std::max<size_t>(requested, 1)) {}
+
+    size_t bucketCount() const
+    {
+        return count;
+    }
+
+    size_t index(size_t hash) const
+    {
+#ifdef __SIZEOF_INT128__
+        return static_cast<size_t>((static_cast<unsigned __int128>(mixBucketHash(hash)) * count) >> 64);
+#else
+        return mixBucketHash(hash) % count;
+#endif
+    }
+
+private:
+    size_t count;
+};
+
+class PrimeBucketPolicy
+{
+public:
+    explicit PrimeBucketPolicy(size_t requested = 1)
+    {
+        static const uint32_t primes[] = {5, 11, 23, 53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157,
+                                          98317, 196613, 393241, 786433, 1572869, 3145739, 6291469, 12582917,
+                                          25165843, 50331653, 100663319, 201326611, 402653189, 805306457,
+                                          1610612741, 3221225473u, 4294967291u};
+        const uint32_t* last = std::end(primes) - 1;
+        prime = *std::min(std::lower_bound(std::begin(primes), last, requested), last);
+        magic = ~uint64_t(0) / prime + 1;
+    }
+
+    size_t bucketCount() const
+    {
+        return prime;
+    }
+
+    size_t index(size_t hash) const
+    {
+        uint32_t folded = static_cast<uint32_t>(hash ^ (static_cast<uint64_t>(hash) >> 32));
+#ifdef __SIZEOF_INT128__
+        uint64_t lowBits = magic * folded;
+        return static_cast<size_t>((static_cast<unsigned __int128>(lowBits) * prime) >> 64);
+#else
+        return folded % prime;
+#endif
+    }
+
+private:
+    uint64_t prime;
+    uint64_t magic;
+};
+
+template<typename Key, typename Hash>
+struct IsFastHash : std::integral_constant<bool, std::is_same<Hash, std::hash<Key>>::value &&
+                                                 (std::is_arithmetic<Key>::value || std::is_enum<Key>::value || std::is_pointer<Key>::value)> {};
+
+template<typename T, typename = void>
+struct IsTransparent : std::false_type {};
+
+template<typename T>
+struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+struct TransparentStringHash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const
+    {
+        return std::hash<std::string_view>()(str);
+    }
+};
+
+struct TransparentStringEqual
+{
+    using is_transparent = void;
+
+    bool operator()(std::string_view lhs, std::string_view rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+class ConcurrentUnorderedMap;
+
+////////////////////////////////////////////////
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Value>>, typename BucketPolicy = ModuloBucketPolicy, bool storeHash = !IsFastHash<Key, Hash>::value>
 class UnorderedMap
 {
 public:
     using NodeType = std::pair<const Key, Value>;
-    using ListIterator = typename List<NodeType, Alloc>::iterator;
-    using ConstListIterator = typename List<NodeType, Alloc>::const_iterator;
-    using ListNode = typename List<NodeType, Alloc>::Node;
+    using ListIterator = typename List<NodeType, Alloc, storeHash>::iterator;
+    using ConstListIterator = typename List<NodeType, Alloc, storeHash>::const_iterator;
+    using ListNode = typename List<NodeType, Alloc, storeHash>::Node;
 
     UnorderedMap();
     UnorderedMap(const UnorderedMap& another);
     UnorderedMap(UnorderedMap&& another);
     explicit UnorderedMap(size_t bucketsCount);
+    explicit UnorderedMap(const Alloc& alloc, size_t bucketsCount = 4);
     ~UnorderedMap() = default;
     UnorderedMap& operator=(const UnorderedMap& another);
     UnorderedMap& operator=(UnorderedMap&& another);
@@ -401,6 +578,7 @@ public:
         using reference = typename std::conditional<isConst, const NodeType&, NodeType&>::type;
         using iterator_category = std::forward_iterator_tag;
 
+        MapIterator() = default;
         MapIterator(ListIterator another) : listIter(another) {}
         MapIterator(ConstListIterator another) : listIter(another) {}
         template<bool isC = false>
@@ -436,9 +614,21 @@ public:
     Iterator find(const Key& key);
     ConstIterator find(const Key& key) const;
     Value& operator[](const Key& key);
+    Value& operator[](Key&& key);
     Value& at(const Key& key);
     const Value& at(const Key& key) const;
 
+    template<typename K, typename = std::enable_if_t<IsTransparent<Hash>::value && IsTransparent<Equal>::value, K>>
+    Iterator find(const K& key);
+    template<typename K, typename = std::enable_if_t<IsTransparent<Hash>::value && IsTransparent<Equal>::value, K>>
+    ConstIterator find(const K& key) const;
+    template<typename K, typename = std::enable_if_t<IsTransparent<Hash>::value && IsTransparent<Equal>::value, K>>
+    Value& operator[](const K& key);
+    template<typename K, typename = std::enable_if_t<IsTransparent<Hash>::value && IsTransparent<Equal>::value, K>>
+    Value& at(const K& key);
+    template<typename K, typename = std::enable_if_t<IsTransparent<Hash>::value && IsTransparent<Equal>::value, K>>
+    const Value& at(const K& key) const;
+
     void rehash(size_t count);
     void reserve(size_t count);
     float load_factor() const;
@@ -446,6 +636,8 @@ public:
     void max_load_factor(float newLoadFactor);
     size_t max_size() const;
     size_t size() const;
+    bool incremental_rehash() const;
+    void incremental_rehash(bool enabled);
 
     std::pair<Iterator,bool> insert(NodeType&& node);
     template<typename Pair>
@@ -456,10 +648,25 @@ public:
     void insert(InputIt first, InputIt last);
     template< class... Args >
     std::pair<Iterator,bool> emplace( Args&&... args );
+    template<typename... Args>
+    std::pair<Iterator, bool> try_emplace(const Key& key, Args&&... args);
+    template<typename... Args>
+    std::pair<Iterator, bool> try_emplace(Key&& key, Args&&... args);
+    template<typename M>
+    std::pair<Iterator, bool> insert_or_assign(const Key& key, M&& value);
+    template<typename M>
+    std::pair<Iterator, bool> insert_or_assign(Key&& key, M&& value);
     Iterator erase(Iterator pos);
     Iterator erase(Iterator first, Iterator last);
 
+    void find_batch(const Key* keys, size_t count, Iterator* out);
+    void find_batch(const Key* keys, size_t count, ConstIterator* out) const;
+    size_t insert_batch(const NodeType* values, size_t count);
+
 private:
+    template<typename, typename, typename, typename, typename>
+    friend class ConcurrentUnorderedMap;
+
     struct Chain
     {
         ListIterator firstElem;
@@ -470,164 +677,260 @@ private:
         ~Chain() = default;
     };
 
-    using chainAlloc = typename Alloc::template rebind<Chain>::other;
+    using chainAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Chain>;
 
-    List<NodeType, Alloc> mainList;
+    List<NodeType, Alloc, storeHash> mainList;
     std::vector<Chain, chainAlloc> buckets;
+    std::vector<Chain, chainAlloc> oldBuckets;
+    std::vector<Chain, chainAlloc> nextBuckets;
     size_t listSz;
     size_t bucketsCnt;
+    size_t oldBucketsCnt = 0;
+    size_t migratePos = 0;
+    BucketPolicy bucketPolicy;
+    BucketPolicy oldBucketPolicy;
+    BucketPolicy nextBucketPolicy;
     float maxLoadFactor;
+    bool incrementalRehash = false;
     Hash hashFunction;
     Equal equalFunction;
 
     void Swap(UnorderedMap& another);
-    size_t getHash(const Key& key);
+    size_t nodeHash(const ListNode* node) const;
+    template<typename K>
+    ListNode* findInChain(const Chain& chain, const K& key, size_t hash) const;
+    template<typename K>
+    ListNode* findNode(const K& key, size_t hash) const;
+    ListIterator linkToBucket(ListNode* node, size_t hash);
+    ListIterator insertNew(ListNode* node, size_t hash);
+    template<typename K, typename... Args>
+    std::pair<Iterator, bool> tryEmplace(size_t hash, K&& key, Args&&... args);
+    void prefetchChains(const size_t* hashes, size_t count, const Chain** chains) const;
+    template<typename Out>
+    void findBatch(const Key* keys, size_t count, Out* out, Out notFound) const;
+    void unlinkFromChain(Chain& chain, ListIterator pos);
+    size_t growTarget(size_t size) const;
+    void grow(size_t count);
+    void prepareStep();
+    void migrateBucket(size_t oldIndex);
+    void migrateStep();
+    void finishMigration();
 };
 ///////////////////////////////////////////////////////
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::UnorderedMap() :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::UnorderedMap() :
         mainList(),
-        buckets(4, Chain(mainList.end(), 0)),
         listSz(0),
-        bucketsCnt(4),
-        maxLoadFactor(defaultMaxLoadFactor) {}
+        bucketsCnt(0),
+        maxLoadFactor(defaultMaxLoadFactor)
+{
+    rehash(4);
+}
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::UnorderedMap(const UnorderedMap& another) :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::UnorderedMap(const UnorderedMap& another) :
         mainList(another.mainList),
-        buckets(another.buckets),
         listSz(another.listSz),
         bucketsCnt(another.bucketsCnt),
         maxLoadFactor(another.maxLoadFactor),
+        incrementalRehash(another.incrementalRehash),
         hashFunction(another.hashFunction),
-        equalFunction(another.equalFunction) {}
+        equalFunction(another.equalFunction)
+{
+    rehash(another.bucketsCnt);
+}
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::UnorderedMap(UnorderedMap&& another) :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::UnorderedMap(UnorderedMap&& another) :
         mainList(move(another.mainList)),
         buckets(move(another.buckets)),
+        oldBuckets(move(another.oldBuckets)),
+        nextBuckets(move(another.nextBuckets)),
         listSz(another.listSz),
         bucketsCnt(another.bucketsCnt),
+        oldBucketsCnt(another.oldBucketsCnt),
+        migratePos(another.migratePos),
+        bucketPolicy(another.bucketPolicy),
+        oldBucketPolicy(another.oldBucketPolicy),
+        nextBucketPolicy(another.nextBucketPolicy),
         maxLoadFactor(another.maxLoadFactor),
+        incrementalRehash(another.incrementalRehash),
         hashFunction(another.hashFunction),
         equalFunction(another.equalFunction)
 {
     another.listSz = 0;
     another.bucketsCnt = 0;
+    another.oldBucketsCnt = 0;
+    another.migratePos = 0;
     another.maxLoadFactor = defaultMaxLoadFactor;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::UnorderedMap(size_t bucketsCount) :
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::UnorderedMap(size_t bucketsCount) :
         mainList(),
-        buckets(bucketsCount, Chain(mainList.end(), 0)),
         listSz(0),
-        bucketsCnt(bucketsCount),
-        maxLoadFactor(defaultMaxLoadFactor) {}
+        bucketsCnt(0),
+        maxLoadFactor(defaultMaxLoadFactor)
+{
+    rehash(bucketsCount);
+}
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-void UnorderedMap<Key, Value, Hash, Equal, Alloc>::Swap(UnorderedMap& another)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::UnorderedMap(const Alloc& alloc, size_t bucketsCount) :
+        mainList(alloc),
+        buckets(chainAlloc(alloc)),
+        oldBuckets(chainAlloc(alloc)),
+        nextBuckets(chainAlloc(alloc)),
+        listSz(0),
+        bucketsCnt(0),
+        maxLoadFactor(defaultMaxLoadFactor)
+{
+    rehash(bucketsCount);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Swap(UnorderedMap& another)
 {
     mainList.Swap(another.mainList);
     std::swap(buckets, another.buckets);
+    std::swap(oldBuckets, another.oldBuckets);
+    std::swap(nextBuckets, another.nextBuckets);
     std::swap(listSz, another.listSz);
     std::swap(bucketsCnt, another.bucketsCnt);
+    std::swap(oldBucketsCnt, another.oldBucketsCnt);
+    std::swap(migratePos, another.migratePos);
+    std::swap(bucketPolicy, another.bucketPolicy);
+    std::swap(oldBucketPolicy, another.oldBucketPolicy);
+    std::swap(nextBucketPolicy, another.nextBucketPolicy);
     std::swap(maxLoadFactor, another.maxLoadFactor);
+    std::swap(incrementalRehash, another.incrementalRehash);
     std::swap(hashFunction, another.hashFunction);
     std::swap(equalFunction, another.equalFunction);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>& UnorderedMap<Key, Value, Hash, Equal, Alloc>::operator=(const UnorderedMap& another)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::operator=(const UnorderedMap& another)
 {
     UnorderedMap copy = another;
     Swap(copy);
     return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>& UnorderedMap<Key, Value, Hash, Equal, Alloc>::operator=(UnorderedMap&& another)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::operator=(UnorderedMap&& another)
 {
     UnorderedMap copy = std::move(another);
     Swap(copy);
     return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::begin()
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::begin()
 {
     return Iterator(mainList.begin());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::end()
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::end()
 {
     return Iterator(mainList.end());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::begin() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::begin() const
 {
     return ConstIterator(mainList.cbegin());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::end() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::end() const
 {
     return ConstIterator(mainList.cend());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::cbegin() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::cbegin() const
 {
     return ConstIterator(mainList.begin());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::cend() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::cend() const
 {
     return ConstIterator(mainList.end());
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::find(const Key& key)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ListNode* UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::findInChain(const Chain& chain, const K& key, size_t hash) const
 {
-    size_t bucketInd = hashFunction(key) % bucketsCnt;
     size_t i = 0;
-    for (auto it = buckets[bucketInd].firstElem; i < buckets[bucketInd].chainSz; ++it, ++i)
+    for (auto it = chain.firstElem; i < chain.chainSz; ++it, ++i)
     {
+        if constexpr (storeHash)
+        {
+            if (it.getPointer() -> hash != hash)
+            {
+                continue;
+            }
+        }
         if (equalFunction(it -> first, key))
         {
-            return Iterator(it);
+            return it.getPointer();
         }
     }
-    return end();
+    return nullptr;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::find(const Key& key) const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ListNode* UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::findNode(const K& key, size_t hash) const
 {
-    size_t bucketInd = hashFunction(key) % bucketsCnt;
-    size_t i = 0;
-    for (auto it = buckets[bucketInd].firstElem; i < buckets[bucketInd].chainSz; ++it, ++i)
+    if (oldBucketsCnt != 0)
     {
-        if (equalFunction(it -> first, key))
+        ListNode* node = findInChain(oldBuckets[oldBucketPolicy.index(hash)], key, hash);
+        if (node != nullptr)
         {
-            return Iterator(it);
+            return node;
         }
     }
-    return cend();
+    return findInChain(buckets[bucketPolicy.index(hash)], key, hash);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-Value& UnorderedMap<Key, Value, Hash, Equal, Alloc>::operator[](const Key& key)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::find(const Key& key)
+{
+    ListNode* node = findNode(key, hashFunction(key));
+    return node == nullptr ? end() : Iterator(ListIterator(node));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::find(const Key& key) const
+{
+    ListNode* node = findNode(key, hashFunction(key));
+    return node == nullptr ? cend() : ConstIterator(ListIterator(node));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::operator[](const Key& key)
+{
+    return (tryEmplace(hashFunction(key), key).first) -> second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::operator[](Key&& key)
+{
+    return (tryEmplace(hashFunction(key), std::move(key)).first) -> second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::at(const Key& key)
 {
     Iterator it = find(key);
     if (it == end())
     {
-        std::pair<Iterator, bool> insertResult = insert({key, Value()});
-        return (insertResult.first) -> second;
+        throw std::out_of_range("out_of_range");
     }
     else
     {
@@ -635,10 +938,10 @@ Value& UnorderedMap<Key, Value, Hash, Equal, Alloc>::operator[](const Key& key)
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-Value& UnorderedMap<Key, Value, Hash, Equal, Alloc>::at(const Key& key)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+const Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::at(const Key& key) const
 {
-    Iterator it = find(key);
+    ConstIterator it = find(key);
     if (it == end())
     {
         throw std::out_of_range("out_of_range");
@@ -649,8 +952,32 @@ Value& UnorderedMap<Key, Value, Hash, Equal, Alloc>::at(const Key& key)
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-const Value& UnorderedMap<Key, Value, Hash, Equal, Alloc>::at(const Key& key) const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K, typename>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::find(const K& key)
+{
+    ListNode* node = findNode(key, hashFunction(key));
+    return node == nullptr ? end() : Iterator(ListIterator(node));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K, typename>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::find(const K& key) const
+{
+    ListNode* node = findNode(key, hashFunction(key));
+    return node == nullptr ? cend() : ConstIterator(ListIterator(node));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K, typename>
+Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::operator[](const K& key)
+{
+    return (tryEmplace(hashFunction(key), key).first) -> second;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K, typename>
+Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::at(const K& key)
 {
     Iterator it = find(key);
     if (it == end())
@@ -663,24 +990,94 @@ const Value& UnorderedMap<Key, Value, Hash, Equal, Alloc>::at(const Key& key) co
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-size_t UnorderedMap<Key, Value, Hash, Equal, Alloc>::size() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K, typename>
+const Value& UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::at(const K& key) const
+{
+    ConstIterator it = find(key);
+    if (it == end())
+    {
+        throw std::out_of_range("out_of_range");
+    }
+    else
+    {
+        return it -> second;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+size_t UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::size() const
 {
     return listSz;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-size_t UnorderedMap<Key, Value, Hash, Equal, Alloc>::getHash(const Key& key)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+size_t UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::nodeHash(const ListNode* node) const
 {
-    return hashFunction(key) % bucketsCnt;
+    if constexpr (storeHash)
+    {
+        return node -> hash;
+    }
+    else
+    {
+        return hashFunction((node -> value).first);
+    }
 }
 
-template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-void UnorderedMap<Key, Value, Hash, Equal, Alloc>::rehash(size_t count)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ListIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::linkToBucket(ListNode* node, size_t hash)
 {
+    Chain& chain = buckets[bucketPolicy.index(hash)];
+    chain.firstElem = mainList.insert(chain.firstElem, node);
+    ++chain.chainSz;
+    return chain.firstElem;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ListIterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insertNew(ListNode* node, size_t hash)
+{
+    listSz++;
+    if (load_factor() > maxLoadFactor)
+    {
+        grow(growTarget(listSz));
+    }
+    else
+    {
+        migrateStep();
+        prepareStep();
+    }
+    if constexpr (storeHash)
+    {
+        node -> hash = hash;
+    }
+    return linkToBucket(node, hash);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::unlinkFromChain(Chain& chain, ListIterator pos)
+{
+    --chain.chainSz;
+    if (chain.chainSz == 0)
+    {
+        chain.firstElem = mainList.end();
+    }
+    else if (chain.firstElem == pos)
+    {
+        ++chain.firstElem;
+    }
+}
+
+template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::rehash(size_t count)
+{
+    oldBuckets.clear();
+    oldBucketsCnt = 0;
+    migratePos = 0;
+    nextBuckets = std::vector<Chain, chainAlloc>(buckets.get_allocator());
+    bucketPolicy = BucketPolicy(count);
+    bucketsCnt = bucketPolicy.bucketCount();
     buckets.clear();
-    buckets.resize(count, Chain(mainList.end(), 0));
-    bucketsCnt = count;
+    buckets.resize(bucketsCnt, Chain(mainList.end(), 0));
 
     if (mainList.size() == 0)
     {
@@ -688,27 +1085,135 @@ void UnorderedMap<Key, Value, Hash, Equal, Alloc>::rehash(size_t count)
     }
     ListNode* node = mainList.head;
     ListNode* lastNode = mainList.fakeTail -> prev;
-    ListNode* nextNode = node;
-    while (node != lastNode)
+    while (true)
     {
-        node = nextNode;
-        nextNode = node -> next;
-        size_t newPos = getHash((node -> value).first);
-        if (buckets[newPos].firstElem == mainList.end())
+        ListNode* nextNode = node -> next;
+        bool isLast = (node == lastNode);
+        linkToBucket(mainList.extractNode(ListIterator(node)), nodeHash(node));
+        if (isLast)
         {
-            buckets[newPos].firstElem = mainList.insert(mainList.end(), mainList.extractNode(ListIterator(node)));
-            ++buckets[newPos].chainSz;
+            break;
         }
-        else
+        node = nextNode;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+size_t UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::growTarget(size_t size) const
+{
+    return 2 * static_cast<size_t>(std::ceil(size / maxLoadFactor));
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::grow(size_t count)
+{
+    if (!incrementalRehash)
+    {
+        rehash(count);
+        return;
+    }
+    finishMigration();
+    BucketPolicy policy(count);
+    if (nextBuckets.capacity() == 0 || nextBucketPolicy.bucketCount() < policy.bucketCount())
+    {
+        nextBuckets = std::vector<Chain, chainAlloc>(buckets.get_allocator());
+        nextBucketPolicy = policy;
+    }
+    nextBuckets.resize(nextBucketPolicy.bucketCount(), Chain(mainList.end(), 0));
+    oldBuckets = std::move(buckets);
+    oldBucketsCnt = bucketsCnt;
+    oldBucketPolicy = bucketPolicy;
+    migratePos = 0;
+    buckets = std::move(nextBuckets);
+    bucketPolicy = nextBucketPolicy;
+    bucketsCnt = bucketPolicy.bucketCount();
+    nextBuckets = std::vector<Chain, chainAlloc>(buckets.get_allocator());
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::prepareStep()
+{
+    if (!incrementalRehash || oldBucketsCnt != 0)
+    {
+        return;
+    }
+    if (nextBuckets.capacity() == 0)
+    {
+        if (4 * listSz <= 3 * maxLoadFactor * bucketsCnt)
         {
-            mainList.insert(buckets[newPos].firstElem, mainList.extractNode(ListIterator(node)));
-            ++buckets[newPos].chainSz;
+            return;
         }
+        nextBucketPolicy = BucketPolicy(growTarget(static_cast<size_t>(maxLoadFactor * bucketsCnt) + 1));
+        nextBuckets.reserve(nextBucketPolicy.bucketCount());
     }
+    size_t count = std::min(nextBuckets.size() + bucketPrepareStep, nextBucketPolicy.bucketCount());
+    nextBuckets.resize(count, Chain(mainList.end(), 0));
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-void UnorderedMap<Key, Value, Hash, Equal, Alloc>::reserve(size_t count)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::migrateBucket(size_t oldIndex)
+{
+    Chain& chain = oldBuckets[oldIndex];
+    ListIterator it = chain.firstElem;
+    for (size_t i = 0; i < chain.chainSz; ++i)
+    {
+        ListIterator next = it;
+        ++next;
+        ListNode* node = mainList.extractNode(it);
+        linkToBucket(node, nodeHash(node));
+        it = next;
+    }
+    chain = Chain(mainList.end(), 0);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::migrateStep()
+{
+    if (oldBucketsCnt == 0)
+    {
+        return;
+    }
+    size_t work = 0;
+    while (migratePos < oldBucketsCnt && work < incrementalRehashStep)
+    {
+        work += 1 + oldBuckets[migratePos].chainSz;
+        migrateBucket(migratePos++);
+    }
+    if (migratePos == oldBucketsCnt)
+    {
+        oldBuckets = std::vector<Chain, chainAlloc>(buckets.get_allocator());
+        oldBucketsCnt = 0;
+        migratePos = 0;
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::finishMigration()
+{
+    while (oldBucketsCnt != 0)
+    {
+        migrateStep();
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+bool UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::incremental_rehash() const
+{
+    return incrementalRehash;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::incremental_rehash(bool enabled)
+{
+    if (!enabled)
+    {
+        finishMigration();
+    }
+    incrementalRehash = enabled;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::reserve(size_t count)
 {
     if (count > maxLoadFactor * bucketsCnt)
     {
@@ -716,20 +1221,20 @@ void UnorderedMap<Key, Value, Hash, Equal, Alloc>::reserve(size_t count)
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-float UnorderedMap<Key, Value, Hash, Equal, Alloc>::load_factor() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+float UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::load_factor() const
 {
     return static_cast<float>(listSz) / bucketsCnt;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-float UnorderedMap<Key, Value, Hash, Equal, Alloc>::max_load_factor() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+float UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::max_load_factor() const
 {
     return maxLoadFactor;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-void UnorderedMap<Key, Value, Hash, Equal, Alloc>:: max_load_factor(float newLoadFactor)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>:: max_load_factor(float newLoadFactor)
 {
     maxLoadFactor = newLoadFactor;
     if (load_factor() > maxLoadFactor)
@@ -738,57 +1243,67 @@ void UnorderedMap<Key, Value, Hash, Equal, Alloc>:: max_load_factor(float newLoa
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-size_t UnorderedMap<Key, Value, Hash, Equal, Alloc>::max_size() const
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+size_t UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::max_size() const
 {
     return maxLoadFactor * bucketsCnt;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::insert(ListNode* node)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert(ListNode* node)
 {
-    Iterator it = find((node -> value).first);
-    if (it != end())
+    size_t hash = hashFunction((node -> value).first);
+    ListNode* found = findNode((node -> value).first, hash);
+    if (found != nullptr)
     {
         mainList.deleteNode(node);
-        return {it, false};
+        return {Iterator(ListIterator(found)), false};
     }
     else
     {
-        listSz++;
-        if (load_factor() > maxLoadFactor)
-        {
-            rehash(2 * static_cast<size_t>(std::ceil(listSz / maxLoadFactor)));
-        }
-        size_t pos = getHash((node -> value).first);
-        ListIterator& listPos = buckets[pos].firstElem;
-        buckets[pos].firstElem = mainList.insert(listPos, node);
-        buckets[pos].chainSz++;
-        return {Iterator(listPos), true};
+        return {Iterator(insertNew(node, hash)), true};
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::insert(UnorderedMap::NodeType&& node)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert(UnorderedMap::NodeType&& node)
 {
-    ListNode* newNode = mainList.makeNode(std::move(node));
-    return insert(newNode);
+    size_t hash = hashFunction(node.first);
+    ListNode* found = findNode(node.first, hash);
+    if (found != nullptr)
+    {
+        return {Iterator(ListIterator(found)), false};
+    }
+    return {Iterator(insertNew(mainList.makeNode(std::move(node)), hash)), true};
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<typename Pair>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::insert(Pair&& pair)
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert(Pair&& pair)
 {
-    ListNode* node = mainList.makeNode(std::forward<Pair>(pair));
-    return insert(node);
+    if constexpr (std::is_same<std::decay_t<decltype(pair.first)>, Key>::value)
+    {
+        size_t hash = hashFunction(pair.first);
+        ListNode* found = findNode(pair.first, hash);
+        if (found != nullptr)
+        {
+            return {Iterator(ListIterator(found)), false};
+        }
+        return {Iterator(insertNew(mainList.makeNode(std::forward<Pair>(pair)), hash)), true};
+    }
+    else
+    {
+        ListNode* node = mainList.makeNode(std::forward<Pair>(pair));
+        return insert(node);
+    }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<typename InputIt>
-void UnorderedMap<Key, Value, Hash, Equal, Alloc>::insert(InputIt begin, InputIt end)
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert(InputIt begin, InputIt end)
 {
     for (InputIt it = begin; it != end; ++it)
     {
@@ -796,113 +1311,251 @@ void UnorderedMap<Key, Value, Hash, Equal, Alloc>::insert(InputIt begin, InputIt
     }
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<typename... Args>
-std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator, bool>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::emplace(Args&& ... args)
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::emplace(Args&& ... args)
 {
     ListNode* node = mainList.makeNode(std::forward<Args>(args)...);
     return insert(node);
 }
 
-template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::erase(Iterator it)
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename K, typename... Args>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::tryEmplace(size_t hash, K&& key, Args&&... args)
+{
+    ListNode* node = findNode(key, hash);
+    if (node != nullptr)
+    {
+        return {Iterator(ListIterator(node)), false};
+    }
+    node = mainList.makeNode(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    return {Iterator(insertNew(node, hash)), true};
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename... Args>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::try_emplace(const Key& key, Args&&... args)
+{
+    return tryEmplace(hashFunction(key), key, std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename... Args>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::try_emplace(Key&& key, Args&&... args)
+{
+    return tryEmplace(hashFunction(key), std::move(key), std::forward<Args>(args)...);
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename M>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert_or_assign(const Key& key, M&& value)
+{
+    std::pair<Iterator, bool> result = tryEmplace(hashFunction(key), key, std::forward<M>(value));
+    if (!result.second)
+    {
+        (result.first) -> second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename M>
+std::pair<typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator, bool>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert_or_assign(Key&& key, M&& value)
+{
+    std::pair<Iterator, bool> result = tryEmplace(hashFunction(key), std::move(key), std::forward<M>(value));
+    if (!result.second)
+    {
+        (result.first) -> second = std::forward<M>(value);
+    }
+    return result;
+}
+
+template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::erase(Iterator it)
 {
     Iterator nextIt = it;
     ++nextIt;
     listSz--;
-    size_t pos = getHash((*it).first);
     ListIterator& listPos = it.getListIter();
-    mainList.erase(listPos);
-    buckets[pos].chainSz--;
-    if (buckets[pos].chainSz == 0)
+    size_t hash = nodeHash(listPos.getPointer());
+    Chain* chain = &buckets[bucketPolicy.index(hash)];
+    if (oldBucketsCnt != 0)
     {
-        buckets[pos].firstElem = mainList.end();
+        Chain& oldChain = oldBuckets[oldBucketPolicy.index(hash)];
+        if (findInChain(oldChain, (*it).first, hash) == listPos.getPointer())
+        {
+            chain = &oldChain;
+        }
     }
+    unlinkFromChain(*chain, listPos);
+    mainList.erase(listPos);
     return nextIt;
 }
 
-template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc>::erase(Iterator first, Iterator last)
+template <typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::Iterator UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::erase(Iterator first, Iterator last)
 {
     Iterator it = first;
     for (; it != last; it = erase(it));
     return it;
 }
 
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::prefetchChains(const size_t* hashes, size_t count, const Chain** chains) const
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        chains[i] = &buckets[bucketPolicy.index(hashes[i])];
+        prefetchMapRead(chains[i]);
+        if (oldBucketsCnt != 0)
+        {
+            prefetchMapRead(&oldBuckets[oldBucketPolicy.index(hashes[i])]);
+        }
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (chains[i] -> chainSz != 0)
+        {
+            prefetchMapRead(chains[i] -> firstElem.getPointer());
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+template<typename Out>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::findBatch(const Key* keys, size_t count, Out* out, Out notFound) const
+{
+    size_t hashes[batchGroupSz];
+    const Chain* chains[batchGroupSz];
+    for (size_t first = 0; first < count; first += batchGroupSz)
+    {
+        size_t groupSz = std::min(batchGroupSz, count - first);
+        for (size_t i = 0; i < groupSz; ++i)
+        {
+            hashes[i] = hashFunction(keys[first + i]);
+        }
+        prefetchChains(hashes, groupSz, chains);
+        for (size_t i = 0; i < groupSz; ++i)
+        {
+            ListNode* node = oldBucketsCnt == 0 ? findInChain(*chains[i], keys[first + i], hashes[i]) : findNode(keys[first + i], hashes[i]);
+            out[first + i] = node == nullptr ? notFound : Out(ListIterator(node));
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::find_batch(const Key* keys, size_t count, Iterator* out)
+{
+    findBatch(keys, count, out, end());
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+void UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::find_batch(const Key* keys, size_t count, ConstIterator* out) const
+{
+    findBatch(keys, count, out, cend());
+}
+
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
+size_t UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::insert_batch(const NodeType* values, size_t count)
+{
+    size_t hashes[batchGroupSz];
+    const Chain* chains[batchGroupSz];
+    size_t inserted = 0;
+    for (size_t first = 0; first < count; first += batchGroupSz)
+    {
+        size_t groupSz = std::min(batchGroupSz, count - first);
+        for (size_t i = 0; i < groupSz; ++i)
+        {
+            hashes[i] = hashFunction(values[first + i].first);
+        }
+        prefetchChains(hashes, groupSz, chains);
+        for (size_t i = 0; i < groupSz; ++i)
+        {
+            inserted += tryEmplace(hashes[i], values[first + i].first, values[first + i].second).second;
+        }
+    }
+    return inserted;
+}
+
 //////////////////////////////////////////////////////////////
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-std::conditional_t<isConst, const typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::NodeType&, typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::NodeType&>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator*() const
+std::conditional_t<isConst, const typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::NodeType&, typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::NodeType&>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator*() const
 {
     return *listIter;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-std::conditional_t<isConst, const typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::NodeType*, typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::NodeType*>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator->()
+std::conditional_t<isConst, const typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::NodeType*, typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::NodeType*>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator->()
 {
     return &(*listIter);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>&
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator++()
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::template MapIterator<isConst>&
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator++()
 {
     ++listIter;
     return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator++(int)
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::template MapIterator<isConst>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator++(int)
 {
     MapIterator copyPtr = *this;
     ++listIter;
     return copyPtr;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>&
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator=(const MapIterator<isConst>& another)
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::template MapIterator<isConst>&
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator=(const MapIterator<isConst>& another)
 {
     listIter = another.listIter;
     return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
 template<bool>
-typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::template MapIterator<isConst>&
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator=(const MapIterator<false>& another)
+typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::template MapIterator<isConst>&
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator=(const MapIterator<false>& another)
 {
     listIter = another.listIter;
     return *this;
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-bool UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator==(const MapIterator &another) const
+bool UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator==(const MapIterator &another) const
 {
     return (listIter == another.listIter);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-bool UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::operator!=(const MapIterator &another) const
+bool UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::operator!=(const MapIterator &another) const
 {
     return !(*this == another);
 }
 
-template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc>
+template<typename Key, typename Value, typename Hash, typename Equal, typename Alloc, typename BucketPolicy, bool storeHash>
 template<bool isConst>
-std::conditional_t<isConst, typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ConstListIterator&, typename UnorderedMap<Key, Value, Hash, Equal, Alloc>::ListIterator&>
-UnorderedMap<Key, Value, Hash, Equal, Alloc>::MapIterator<isConst>::getListIter()
+std::conditional_t<isConst, typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ConstListIterator&, typename UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::ListIterator&>
+UnorderedMap<Key, Value, Hash, Equal, Alloc, BucketPolicy, storeHash>::MapIterator<isConst>::getListIter()
 {
     return listIter;
 }
\ No newline at end of file
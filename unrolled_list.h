@@ -0,0 +1,649 @@
+#pragma once
+
+#include "fastallocator.h"
+
+const size_t unrolledNodeBytes = 2 * cacheLineSz;
+
+template<typename T, typename Allocator = FastAllocator<T>>
+class UnrolledList
+{
+private:
+    struct Node
+    {
+        static constexpr size_t headerSz = 2 * sizeof(Node*) + sizeof(size_t);
+        static constexpr size_t capacity = (unrolledNodeBytes > headerSz + sizeof(T)) ? (unrolledNodeBytes - headerSz) / sizeof(T) : 1;
+
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        size_t count = 0;
+        alignas(T) int8_t storage[capacity * sizeof(T)];
+
+        T* values();
+        bool full() const;
+    };
+
+    Node* head;
+    Node* fakeTail;
+    size_t sz = 0;
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> AllocNode;
+    AllocNode alloc;
+
+    using AllocTraits = std::allocator_traits<AllocNode>;
+
+    void createFakeTail();
+    Node* makeNode();
+    void deleteNode(Node* node);
+    Node* linkNodeBefore(Node* pos);
+    void unlinkNode(Node* node);
+    void splitNode(Node* node);
+    void absorbNext(Node* node);
+
+public:
+    explicit UnrolledList(const Allocator& alloc = Allocator());
+    explicit UnrolledList(size_t count, const Allocator& alloc = Allocator());
+    explicit UnrolledList(size_t count, const T& value, const Allocator& alloc = Allocator());
+    UnrolledList(const UnrolledList& another);
+    UnrolledList(UnrolledList&& another);
+    ~UnrolledList();
+
+    static constexpr size_t nodeCapacity = Node::capacity;
+
+    template <bool isConst>
+    class common_iterator
+    {
+    public:
+        friend UnrolledList;
+
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename std::conditional<isConst, const T, T>::type;
+        using pointer = typename std::conditional<isConst, const T*, T*>::type;
+        using reference = typename std::conditional<isConst, const T&, T&>::type;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        common_iterator(const common_iterator& another) = default;
+        ~common_iterator() = default;
+
+        std::conditional_t<isConst, const T&, T&> operator*() const;
+        std::conditional_t<isConst, const T*, T*> operator->() const;
+        common_iterator& operator++();
+        common_iterator operator++(int);
+        common_iterator& operator--();
+        common_iterator operator--(int);
+        common_iterator& operator=(const common_iterator& another) = default;
+
+        bool operator==(const common_iterator &another) const;
+        bool operator!=(const common_iterator &another) const;
+
+        operator common_iterator<true>() const;
+
+    private:
+        Node* ptr = nullptr;
+        size_t ind = 0;
+
+        common_iterator(Node* p, size_t i);
+    };
+    using iterator = common_iterator<false>;
+    using const_iterator = common_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+    UnrolledList& operator=(const UnrolledList& another);
+    UnrolledList& operator=(UnrolledList&& another);
+    AllocNode get_allocator() const;
+    iterator insert(const_iterator it, const T& val);
+    iterator insert(const_iterator it, T&& val);
+    template<typename... Args>
+    iterator emplace(const_iterator it, Args&&... args);
+    template<typename... Args>
+    T& emplace_back(Args&&... args);
+    template<typename... Args>
+    T& emplace_front(Args&&... args);
+    iterator erase(const_iterator it);
+    void push_back(const T& value);
+    void push_back(T&& value);
+    void push_front(const T& value);
+    void push_front(T&& value);
+    void pop_back();
+    void pop_front();
+    void clear();
+    size_t size() const;
+};
+
+//////////////////////////////////////////
+template<typename T, typename Allocator>
+T* UnrolledList<T, Allocator>::Node::values()
+{
+    return reinterpret_cast<T*>(storage);
+}
+
+template<typename T, typename Allocator>
+bool UnrolledList<T, Allocator>::Node::full() const
+{
+    return count == capacity;
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::createFakeTail()
+{
+    fakeTail = makeNode();
+    head = fakeTail;
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::Node* UnrolledList<T, Allocator>::makeNode()
+{
+    Node* node = AllocTraits::allocate(alloc, 1);
+    node -> prev = nullptr;
+    node -> next = nullptr;
+    node -> count = 0;
+    return node;
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::deleteNode(Node* node)
+{
+    T* values = node -> values();
+    for (size_t i = 0; i < node -> count; ++i)
+    {
+        values[i].~T();
+    }
+    AllocTraits::deallocate(alloc, node, 1);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::Node* UnrolledList<T, Allocator>::linkNodeBefore(Node* pos)
+{
+    Node* node = makeNode();
+    node -> next = pos;
+    node -> prev = pos -> prev;
+    if (pos -> prev != nullptr)
+    {
+        pos -> prev -> next = node;
+    }
+    else
+    {
+        head = node;
+    }
+    pos -> prev = node;
+    return node;
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::unlinkNode(Node* node)
+{
+    node -> next -> prev = node -> prev;
+    if (node -> prev != nullptr)
+    {
+        node -> prev -> next = node -> next;
+    }
+    else
+    {
+        head = node -> next;
+    }
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::splitNode(Node* node)
+{
+    Node* right = linkNodeBefore(node -> next);
+    size_t keep = node -> count / 2;
+    T* from = node -> values();
+    T* to = right -> values();
+    for (size_t i = keep; i < node -> count; ++i)
+    {
+        new(to + right -> count) T(std::move(from[i]));
+        ++right -> count;
+        from[i].~T();
+    }
+    node -> count = keep;
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::absorbNext(Node* node)
+{
+    Node* next = node -> next;
+    T* from = next -> values();
+    T* to = node -> values();
+    for (size_t i = 0; i < next -> count; ++i)
+    {
+        new(to + node -> count) T(std::move(from[i]));
+        ++node -> count;
+        from[i].~T();
+    }
+    next -> count = 0;
+    unlinkNode(next);
+    deleteNode(next);
+}
+
+template<typename T, typename Allocator>
+UnrolledList<T, Allocator>::UnrolledList(const Allocator& allocator) : sz(0), alloc(allocator)
+{
+    createFakeTail();
+}
+
+template<typename T, typename Allocator>
+UnrolledList<T, Allocator>::UnrolledList(size_t count, const Allocator& allocator) : UnrolledList(allocator)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        emplace_back();
+    }
+}
+
+template<typename T, typename Allocator>
+UnrolledList<T, Allocator>::UnrolledList(size_t count, const T& value, const Allocator& allocator) : UnrolledList(allocator)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        push_back(value);
+    }
+}
+
+template<typename T, typename Allocator>
+UnrolledList<T, Allocator>::UnrolledList(const UnrolledList& another) : UnrolledList(std::allocator_traits<Allocator>::select_on_container_copy_construction(another.alloc))
+{
+    for (const T& value : another)
+    {
+        push_back(value);
+    }
+}
+
+template<typename T, typename Allocator>
+UnrolledList<T, Allocator>::UnrolledList(UnrolledList&& another) : head(another.head), fakeTail(another.fakeTail), sz(another.sz), alloc(std::move(another.alloc))
+{
+    another.sz = 0;
+    another.createFakeTail();
+}
+
+template<typename T, typename Allocator>
+UnrolledList<T, Allocator>::~UnrolledList()
+{
+    clear();
+    AllocTraits::deallocate(alloc, fakeTail, 1);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::UnrolledList& UnrolledList<T, Allocator>::operator=(const UnrolledList& another)
+{
+    if (this == &another)
+    {
+        return *this;
+    }
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value)
+    {
+        AllocTraits::deallocate(alloc, fakeTail, 1);
+        alloc = another.alloc;
+        createFakeTail();
+    }
+    for (const T& value : another)
+    {
+        push_back(value);
+    }
+    return *this;
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::UnrolledList& UnrolledList<T, Allocator>::operator=(UnrolledList&& another)
+{
+    if (this == &another)
+    {
+        return *this;
+    }
+    clear();
+    if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value)
+    {
+        AllocTraits::deallocate(alloc, fakeTail, 1);
+        alloc = std::move(another.alloc);
+        head = another.head;
+        fakeTail = another.fakeTail;
+        sz = another.sz;
+        another.sz = 0;
+        another.createFakeTail();
+    }
+    else
+    {
+        for (T& value : another)
+        {
+            emplace_back(std::move(value));
+        }
+    }
+    return *this;
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::clear()
+{
+    Node* node = head;
+    while (node != fakeTail)
+    {
+        Node* next = node -> next;
+        deleteNode(node);
+        node = next;
+    }
+    fakeTail -> prev = nullptr;
+    head = fakeTail;
+    sz = 0;
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::iterator UnrolledList<T, Allocator>::insert(const_iterator it, const T& val)
+{
+    return emplace(it, val);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::iterator UnrolledList<T, Allocator>::insert(const_iterator it, T&& val)
+{
+    return emplace(it, std::move(val));
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+typename UnrolledList<T, Allocator>::iterator UnrolledList<T, Allocator>::emplace(const_iterator it, Args&&... args)
+{
+    Node* node = it.ptr;
+    size_t ind = it.ind;
+    if (ind == 0 && node -> prev != nullptr && !node -> prev -> full())
+    {
+        node = node -> prev;
+        ind = node -> count;
+    }
+    else if (node == fakeTail || (ind == 0 && node -> full()))
+    {
+        node = linkNodeBefore(node);
+        ind = 0;
+    }
+    else if (node -> full())
+    {
+        splitNode(node);
+        if (ind > node -> count)
+        {
+            ind -= node -> count;
+            node = node -> next;
+        }
+    }
+
+    T* values = node -> values();
+    if (ind == node -> count)
+    {
+        new(values + ind) T(std::forward<Args>(args)...);
+    }
+    else
+    {
+        T value(std::forward<Args>(args)...);
+        new(values + node -> count) T(std::move(values[node -> count - 1]));
+        std::move_backward(values + ind, values + node -> count - 1, values + node -> count);
+        values[ind] = std::move(value);
+    }
+    ++node -> count;
+    ++sz;
+    return iterator(node, ind);
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+T& UnrolledList<T, Allocator>::emplace_back(Args&&... args)
+{
+    return *emplace(cend(), std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator>
+template<typename... Args>
+T& UnrolledList<T, Allocator>::emplace_front(Args&&... args)
+{
+    return *emplace(cbegin(), std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::iterator UnrolledList<T, Allocator>::erase(const_iterator it)
+{
+    Node* node = it.ptr;
+    size_t ind = it.ind;
+    T* values = node -> values();
+    std::move(values + ind + 1, values + node -> count, values + ind);
+    values[node -> count - 1].~T();
+    --node -> count;
+    --sz;
+
+    if (node -> count == 0)
+    {
+        Node* next = node -> next;
+        unlinkNode(node);
+        deleteNode(node);
+        return iterator(next, 0);
+    }
+    Node* next = node -> next;
+    if (next != fakeTail && node -> count + next -> count <= Node::capacity / 2)
+    {
+        absorbNext(node);
+    }
+    if (ind == node -> count)
+    {
+        return iterator(node -> next, 0);
+    }
+    return iterator(node, ind);
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::push_back(const T& value)
+{
+    emplace(cend(), value);
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::push_back(T&& value)
+{
+    emplace(cend(), std::move(value));
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::push_front(const T& value)
+{
+    emplace(cbegin(), value);
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::push_front(T&& value)
+{
+    emplace(cbegin(), std::move(value));
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::pop_back()
+{
+    const_iterator it = cend();
+    it--;
+    erase(it);
+}
+
+template<typename T, typename Allocator>
+void UnrolledList<T, Allocator>::pop_front()
+{
+    erase(cbegin());
+}
+
+template<typename T, typename Allocator>
+size_t UnrolledList<T, Allocator>::size() const
+{
+    return sz;
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::AllocNode UnrolledList<T, Allocator>::get_allocator() const
+{
+    return alloc;
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::iterator UnrolledList<T, Allocator>::begin()
+{
+    return iterator(head, 0);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::iterator UnrolledList<T, Allocator>::end()
+{
+    return iterator(fakeTail, 0);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_iterator UnrolledList<T, Allocator>::begin() const
+{
+    return const_iterator(head, 0);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_iterator UnrolledList<T, Allocator>::end() const
+{
+    return const_iterator(fakeTail, 0);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_iterator UnrolledList<T, Allocator>::cbegin() const
+{
+    return const_iterator(head, 0);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_iterator UnrolledList<T, Allocator>::cend() const
+{
+    return const_iterator(fakeTail, 0);
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::reverse_iterator UnrolledList<T, Allocator>::rbegin()
+{
+    return std::make_reverse_iterator(end());
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::reverse_iterator UnrolledList<T, Allocator>::rend()
+{
+    return std::make_reverse_iterator(begin());
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_reverse_iterator UnrolledList<T, Allocator>::rbegin() const
+{
+    return std::make_reverse_iterator(end());
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_reverse_iterator UnrolledList<T, Allocator>::rend() const
+{
+    return std::make_reverse_iterator(begin());
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_reverse_iterator UnrolledList<T, Allocator>::crbegin() const
+{
+    return std::make_reverse_iterator(end());
+}
+
+template<typename T, typename Allocator>
+typename UnrolledList<T, Allocator>::const_reverse_iterator UnrolledList<T, Allocator>::crend() const
+{
+    return std::make_reverse_iterator(begin());
+}
+
+///////////////////////////////////////////////
+template<typename T, typename Allocator>
+template<bool isConst>
+UnrolledList<T, Allocator>::common_iterator<isConst>::common_iterator(Node* p, size_t i)
+{
+    ptr = p;
+    ind = i;
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+std::conditional_t<isConst, const T&, T&> UnrolledList<T, Allocator>::common_iterator<isConst>::operator*() const
+{
+    return ptr -> values()[ind];
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+std::conditional_t<isConst, const T*, T*> UnrolledList<T, Allocator>::common_iterator<isConst>::operator->() const
+{
+    return ptr -> values() + ind;
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+typename UnrolledList<T, Allocator>::template common_iterator<isConst>& UnrolledList<T, Allocator>::common_iterator<isConst>::operator++()
+{
+    if (++ind == ptr -> count)
+    {
+        ptr = ptr -> next;
+        ind = 0;
+    }
+    return *this;
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+typename UnrolledList<T, Allocator>::template common_iterator<isConst> UnrolledList<T, Allocator>::common_iterator<isConst>::operator++(int)
+{
+    common_iterator copyPtr = *this;
+    ++(*this);
+    return copyPtr;
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+typename UnrolledList<T, Allocator>::template common_iterator<isConst>& UnrolledList<T, Allocator>::common_iterator<isConst>::operator--()
+{
+    if (ind == 0)
+    {
+        ptr = ptr -> prev;
+        ind = ptr -> count;
+    }
+    --ind;
+    return *this;
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+typename UnrolledList<T, Allocator>::template common_iterator<isConst> UnrolledList<T, Allocator>::common_iterator<isConst>::operator--(int)
+{
+    common_iterator copyPtr = *this;
+    --(*this);
+    return copyPtr;
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+bool UnrolledList<T, Allocator>::common_iterator<isConst>::operator==(const common_iterator &another) const
+{
+    return (ptr == another.ptr && ind == another.ind);
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+bool UnrolledList<T, Allocator>::common_iterator<isConst>::operator!=(const common_iterator &another) const
+{
+    return !(*this == another);
+}
+
+template<typename T, typename Allocator>
+template<bool isConst>
+UnrolledList<T, Allocator>::common_iterator<isConst>::operator common_iterator<true>() const
+{
+    return common_iterator<true>(ptr, ind);
+}